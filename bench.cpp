@@ -0,0 +1,278 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rijndael.h"
+#include "rijndael_bulk.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RIJNDAEL_HAVE_TSC 1
+#endif
+
+using namespace Rijndael;
+
+// Measures every public entry point over message sizes from 16 B up to
+// --max-size (64 MiB by default) and writes one CSV or JSON record per run.
+// Per-engine sweeps stop at --engine-max-size; larger sizes run on the Auto
+// engine only. Cycles are read from the TSC, so they count reference cycles
+// at the nominal clock rather than core cycles.
+
+struct Result
+{
+    std::string name;
+    std::string engine;
+    int keyBits;
+    size_t bytes;
+    unsigned int threads;
+    uint64_t ops;
+    double seconds;
+    uint64_t cycles;
+};
+
+struct Options
+{
+    size_t maxSize = 64 << 20;
+    size_t engineMaxSize = 16 << 20;
+    double minTime = 0.2;
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    bool json = false;
+    const char * output = 0;
+};
+
+static Options options;
+static std::vector<Result> results;
+static volatile unsigned char sink;
+
+// Fixed input for the single-block runs.
+static const unsigned char sampleBlock[16] = {
+    0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d, 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34
+};
+
+static inline uint64_t cycles()
+{
+#ifdef RIJNDAEL_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static const char * engineName(Engine engine)
+{
+    switch( engine ) {
+    case Engine::Reference: return "reference";
+    case Engine::TTable: return "ttable";
+    case Engine::AesNi: return "aesni";
+    case Engine::Bitsliced: return "bitsliced";
+    default: return "auto";
+    }
+}
+
+// Runs op once to warm caches, then repeatedly for at least minTime.
+template<class F>
+static void measure(const char * name, Engine engine, int keyBits, size_t bytes, unsigned int threads, F op)
+{
+    op();
+
+    uint64_t ops = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t c0 = cycles();
+    double elapsed;
+    do {
+        op();
+        ops++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while( elapsed < options.minTime );
+    uint64_t c1 = cycles();
+
+    results.push_back(Result{ name, engineName(engine), keyBits, bytes, threads, ops, elapsed, c1 - c0 });
+    std::cerr << name << " " << engineName(engine) << " aes-" << keyBits << " " << bytes << " B x" << threads
+              << ": " << elapsed * 1e9 / ops << " ns/op" << std::endl;
+}
+
+template<int KeyBits>
+static void benchKeyExpansion(Engine engine)
+{
+    unsigned char key[32] = { 0 };
+
+    measure("key_expansion", engine, KeyBits, 0, 1, [&] {
+        key[0]++;
+        Cipher<KeyBits> cipher(key, engine);
+        sink ^= cipher.encrypt(Block::load(sampleBlock)).get(0, 0);
+    });
+}
+
+template<int KeyBits>
+static void benchBlock(Engine engine)
+{
+    unsigned char key[32] = { 0 };
+    Cipher<KeyBits> cipher(key, engine);
+    Block state = Block::load(sampleBlock);
+
+    measure("encrypt_block", engine, KeyBits, 16, 1, [&] { state = cipher.encrypt(state); });
+    measure("decrypt_block", engine, KeyBits, 16, 1, [&] { state = cipher.decrypt(state); });
+    sink ^= state.get(0, 0);
+}
+
+static void benchBlocks(Engine engine, unsigned char * buffer, size_t bytes)
+{
+    unsigned char key[16] = { 0 };
+    Cipher<128> cipher(key, engine);
+
+    measure("encrypt_blocks", cipher.engine(), 128, bytes, 1, [&] { cipher.encryptBlocks(buffer, buffer, bytes / 16); });
+    measure("decrypt_blocks", cipher.engine(), 128, bytes, 1, [&] { cipher.decryptBlocks(buffer, buffer, bytes / 16); });
+}
+
+static void benchStrings(Engine engine, unsigned char * buffer, char * text, size_t bytes)
+{
+    unsigned char key[16] = { 0 };
+    Cipher<128> cipher(key, engine);
+    std::string_view plaintext((const char *) buffer, bytes);
+    size_t length = cipher.encrypt(plaintext, text);
+    std::string_view ciphertext(text, length);
+
+    measure("string_encrypt", cipher.engine(), 128, bytes, 1, [&] { cipher.encrypt(plaintext, text); });
+    measure("string_decrypt", cipher.engine(), 128, bytes, 1, [&] {
+        size_t written;
+        cipher.decrypt(ciphertext, buffer, written);
+    });
+}
+
+static void benchBase64(unsigned char * buffer, char * text, size_t bytes)
+{
+    size_t length = base64_encoded_size(bytes);
+
+    measure("base64_encode", Engine::Auto, 0, bytes, 1, [&] { base64_encode(buffer, bytes, text); });
+    measure("base64_decode", Engine::Auto, 0, bytes, 1, [&] {
+        size_t written;
+        base64_decode(text, length, buffer, written);
+    });
+}
+
+static void benchThreads(unsigned char * buffer, size_t bytes)
+{
+    unsigned char key[16] = { 0 };
+    unsigned char counter[16] = { 0 };
+    Cipher<128> cipher(key);
+
+    std::vector<unsigned int> counts;
+    for(unsigned int threads = 1; threads < options.maxThreads; threads *= 2) counts.push_back(threads);
+    counts.push_back(options.maxThreads);
+
+    for(unsigned int threads : counts) {
+        ThreadPool pool(threads);
+        Bulk bulk(cipher, &pool);
+
+        measure("bulk_ecb_encrypt", cipher.engine(), 128, bytes, threads, [&] { bulk.encryptEcb(buffer, buffer, bytes / 16); });
+        measure("bulk_ctr", cipher.engine(), 128, bytes, threads, [&] { bulk.ctr(counter, 0, buffer, buffer, bytes); });
+    }
+}
+
+static void writeCsv(std::ostream & out)
+{
+    out << "name,engine,key_bits,bytes,threads,ops,ns_per_op,cycles_per_op,cycles_per_byte,mb_per_s" << std::endl;
+    for(size_t i = 0; i < results.size(); i++) {
+        const Result & r = results[i];
+        double ns = r.seconds * 1e9 / r.ops;
+        double cpo = (double) r.cycles / r.ops;
+        out << r.name << "," << r.engine << "," << r.keyBits << "," << r.bytes << "," << r.threads << "," << r.ops << ","
+            << ns << "," << cpo << "," << (r.bytes ? cpo / r.bytes : 0) << "," << (r.bytes ? r.bytes / ns * 1e3 : 0) << std::endl;
+    }
+}
+
+static void writeJson(std::ostream & out)
+{
+    out << "[" << std::endl;
+    for(size_t i = 0; i < results.size(); i++) {
+        const Result & r = results[i];
+        double ns = r.seconds * 1e9 / r.ops;
+        double cpo = (double) r.cycles / r.ops;
+        out << "  {\"name\": \"" << r.name << "\", \"engine\": \"" << r.engine << "\", \"key_bits\": " << r.keyBits
+            << ", \"bytes\": " << r.bytes << ", \"threads\": " << r.threads << ", \"ops\": " << r.ops
+            << ", \"ns_per_op\": " << ns << ", \"cycles_per_op\": " << cpo
+            << ", \"cycles_per_byte\": " << (r.bytes ? cpo / r.bytes : 0) << ", \"mb_per_s\": " << (r.bytes ? r.bytes / ns * 1e3 : 0)
+            << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+static bool parseOptions(int argc, char ** argv)
+{
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char * value = i + 1 < argc ? argv[i + 1] : 0;
+
+        if( arg == "--json" ) options.json = true;
+        else if( arg == "--csv" ) options.json = false;
+        else if( value == 0 ) return false;
+        else if( arg == "--max-size" ) options.maxSize = strtoull(value, 0, 10), i++;
+        else if( arg == "--engine-max-size" ) options.engineMaxSize = strtoull(value, 0, 10), i++;
+        else if( arg == "--min-time" ) options.minTime = atof(value), i++;
+        else if( arg == "--threads" ) options.maxThreads = atoi(value), i++;
+        else if( arg == "--output" ) options.output = value, i++;
+        else return false;
+    }
+
+    if( options.maxThreads == 0 ) options.maxThreads = 1;
+    if( options.maxSize < 16 ) options.maxSize = 16;
+    return true;
+}
+
+int main(int argc, char ** argv)
+{
+    if( !parseOptions(argc, argv) ) {
+        std::cerr << "usage: " << argv[0] << " [--csv|--json] [--output file] [--max-size bytes] [--engine-max-size bytes]"
+                  << " [--min-time seconds] [--threads n]" << std::endl;
+        return 2;
+    }
+
+    const Engine engines[] = { Engine::Reference, Engine::TTable, Engine::AesNi, Engine::Bitsliced };
+    for(Engine engine : engines) {
+        if( selectEngine(engine) != engine ) continue;
+        benchKeyExpansion<128>(engine);
+        benchKeyExpansion<192>(engine);
+        benchKeyExpansion<256>(engine);
+        benchBlock<128>(engine);
+        benchBlock<192>(engine);
+        benchBlock<256>(engine);
+    }
+
+    // Decryption through the string API may write up to a block past bytes.
+    std::vector<unsigned char> buffer(options.maxSize + 16, 0x5a);
+    std::vector<char> text(base64_encoded_size(options.maxSize));
+
+    // Sizes grow by 16x and end on the maximum itself.
+    for(size_t bytes = 16; ; bytes = bytes * 16 < options.maxSize ? bytes * 16 : options.maxSize) {
+        for(Engine engine : engines) {
+            if( selectEngine(engine) != engine || bytes > options.engineMaxSize ) continue;
+            benchBlocks(engine, buffer.data(), bytes);
+            benchStrings(engine, buffer.data(), text.data(), bytes);
+        }
+
+        if( bytes > options.engineMaxSize ) {
+            benchBlocks(Engine::Auto, buffer.data(), bytes);
+            benchStrings(Engine::Auto, buffer.data(), text.data(), bytes);
+        }
+
+        benchBase64(buffer.data(), text.data(), bytes);
+        if( bytes >= (1 << 20) ) benchThreads(buffer.data(), bytes);
+
+        if( bytes == options.maxSize ) break;
+    }
+
+    if( options.output ) {
+        std::ofstream file(options.output);
+        if( options.json ) writeJson(file);
+        else writeCsv(file);
+    } else {
+        if( options.json ) writeJson(std::cout);
+        else writeCsv(std::cout);
+    }
+
+    return 0;
+}
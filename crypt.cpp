@@ -0,0 +1,424 @@
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "rijndael.h"
+#include "rijndael_gcm.h"
+#include "rijndael_selftest.h"
+#include "rijndael_threadpool.h"
+
+using namespace Rijndael;
+
+// Files are sealed with AES-GCM in independent records of recordSize
+// plaintext bytes, each followed by its 16-byte tag. Every record's IV is a
+// random per-file nonce followed by the record number, and the file header
+// (magic, nonce, plaintext length) is authenticated as every record's AAD,
+// so records cannot be altered, reordered, dropped or moved to another
+// file. An empty file still gets one empty record to authenticate the
+// header.
+//
+// Data goes through windows of windowRecords records: while one window is
+// processed on the thread pool, a reader thread faults the next input
+// window in, and finished output windows are handed to the kernel for
+// writeback and unmapped. Memory use stays at two windows whatever the
+// file size.
+//
+// Decryption checks every tag before the output file is even created, then
+// decrypts each record into private memory and checks its tag again before
+// copying it out, so no unauthenticated plaintext is ever written. Output
+// goes to a temporary file next to the target that is renamed over it only
+// on success.
+
+static const size_t recordSize = 1 << 20;
+static const size_t windowRecords = 64;
+static const size_t tagSize = 16;
+static const size_t headerSize = 32;
+static const char magic[8] = { 'R', 'J', 'N', 'D', 'G', 'C', 'M', '1' };
+
+// header: magic[8] nonce[12] reserved[4] plaintext length[8, big-endian]
+struct Layout
+{
+    uint64_t length;
+    uint64_t records;
+
+    Layout(uint64_t plaintextLength) : length(plaintextLength), records(length == 0 ? 1 : (length + recordSize - 1) / recordSize) {}
+
+    size_t plainSize(uint64_t r) const { return length - r * recordSize < recordSize ? length - r * recordSize : recordSize; }
+    uint64_t plainStart(uint64_t r) const { return r * recordSize; }
+    uint64_t sealedStart(uint64_t r) const { return headerSize + r * (recordSize + tagSize); }
+    uint64_t sealedSize() const { return headerSize + length + records * tagSize; }
+};
+
+// A mapping of length bytes at any file offset; mmap itself needs offsets
+// on page boundaries. An empty mapping maps nothing.
+class Mapping
+{
+protected:
+    void * _base;
+    size_t _size;
+    unsigned char * _data;
+
+public:
+    Mapping() : _base(MAP_FAILED), _size(0), _data(0) {}
+    ~Mapping() { unmap(); }
+
+    bool map(int fd, uint64_t offset, size_t length, bool writable)
+    {
+        static const uint64_t page = sysconf(_SC_PAGESIZE);
+        uint64_t start = offset / page * page;
+
+        unmap();
+        if( length == 0 ) return true;
+
+        _size = length + (offset - start);
+        _base = mmap(0, _size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, start);
+        if( _base == MAP_FAILED ) return false;
+
+        _data = (unsigned char *) _base + (offset - start);
+        madvise(_base, _size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    void unmap()
+    {
+        _data = 0;
+        if( _base == MAP_FAILED ) return;
+        munmap(_base, _size);
+        _base = MAP_FAILED;
+    }
+
+    // Starts writeback without waiting for it.
+    void flush() { if( _base != MAP_FAILED ) msync(_base, _size, MS_ASYNC); }
+
+    unsigned char * data() { return _data; }
+};
+
+// Touches one byte per page so the window is read from disk by this thread.
+static void prefetch(const unsigned char * data, size_t length)
+{
+    static const size_t page = sysconf(_SC_PAGESIZE);
+    volatile unsigned char sink = 0;
+    for(size_t i = 0; i < length; i += page) sink ^= data[i];
+    (void) sink;
+}
+
+// Calls fn(first, last, data) for each window of records [first, last),
+// with data pointing at record first in the input, mapped read-only.
+// sealed says whether the input holds records with tags or bare plaintext.
+static bool forEachWindow(const Layout & layout, int in, bool sealed,
+                          const std::function<bool(uint64_t, uint64_t, const unsigned char *)> & fn)
+{
+    auto range = [&](uint64_t first, uint64_t last, uint64_t & offset, size_t & length) {
+        offset = sealed ? layout.sealedStart(first) : layout.plainStart(first);
+        uint64_t end = sealed ? layout.sealedStart(last - 1) + layout.plainSize(last - 1) + tagSize
+                              : layout.plainStart(last - 1) + layout.plainSize(last - 1);
+        length = end - offset;
+    };
+
+    Mapping input[2];
+    uint64_t offset;
+    size_t length;
+    uint64_t last = layout.records < windowRecords ? layout.records : windowRecords;
+    range(0, last, offset, length);
+    if( !input[0].map(in, offset, length, false) ) return false;
+
+    for(uint64_t first = 0, w = 0; first < layout.records; first = last, w ^= 1) {
+        last = layout.records - first < windowRecords ? layout.records : first + windowRecords;
+        std::thread reader;
+
+        // Double buffering: fault the next input window in while this one
+        // is processed.
+        if( last < layout.records ) {
+            uint64_t next = layout.records - last < windowRecords ? layout.records : last + windowRecords;
+            range(last, next, offset, length);
+            if( !input[w ^ 1].map(in, offset, length, false) ) return false;
+            reader = std::thread(prefetch, input[w ^ 1].data(), length);
+        }
+
+        bool ok = fn(first, last, input[w].data());
+        input[w].unmap();
+
+        if( reader.joinable() ) reader.join();
+        if( !ok ) return false;
+    }
+
+    return true;
+}
+
+static void recordIv(const unsigned char header[headerSize], uint64_t record, unsigned char iv[16])
+{
+    memcpy(iv, header + 8, 12);
+    iv[12] = record >> 24; iv[13] = record >> 16; iv[14] = record >> 8; iv[15] = record;
+}
+
+// Maps the output bytes of records [first, last), runs fn on them and
+// starts their writeback.
+static bool withOutput(int out, uint64_t offset, size_t length, const std::function<void(unsigned char *)> & fn)
+{
+    Mapping output;
+    if( !output.map(out, offset, length, true) ) return false;
+    fn(output.data());
+    output.flush();
+    return true;
+}
+
+template<int KeyBits>
+static bool seal(const unsigned char * key, int in, int out, uint64_t inSize, ThreadPool & pool)
+{
+    Cipher<KeyBits> cipher(key);
+    Layout layout(inSize);
+    unsigned char header[headerSize] = { 0 };
+
+    if( layout.records > ((uint64_t) 1 << 32) ) return false;
+
+    std::random_device random;
+    memcpy(header, magic, 8);
+    for(int i = 0; i < 12; i += 4) {
+        uint32_t r = random();
+        memcpy(header + 8 + i, &r, 4);
+    }
+    for(int i = 0; i < 8; i++) header[24 + i] = layout.length >> (56 - 8 * i);
+
+    if( pwrite(out, header, headerSize, 0) != (ssize_t) headerSize ) return false;
+
+    return forEachWindow(layout, in, false, [&](uint64_t first, uint64_t last, const unsigned char * data) {
+        uint64_t start = layout.sealedStart(first);
+        size_t length = layout.sealedStart(last - 1) + layout.plainSize(last - 1) + tagSize - start;
+
+        return withOutput(out, start, length, [&](unsigned char * sealed) {
+            pool.run(last - first, [&](size_t i) {
+                uint64_t r = first + i;
+                size_t n = layout.plainSize(r);
+                unsigned char iv[16];
+                unsigned char * o = sealed + (layout.sealedStart(r) - start);
+                Gcm gcm(cipher);
+
+                recordIv(header, r, iv);
+                gcm.encrypt(iv, 16, header, headerSize, data + (layout.plainStart(r) - layout.plainStart(first)), o, n, o + n);
+            });
+        });
+    });
+}
+
+template<int KeyBits>
+static bool verifyAll(const Cipher<KeyBits> & cipher, const unsigned char header[headerSize], const Layout & layout, int in, ThreadPool & pool)
+{
+    return forEachWindow(layout, in, true, [&](uint64_t first, uint64_t last, const unsigned char * data) {
+        std::atomic<bool> ok(true);
+        pool.run(last - first, [&](size_t i) {
+            uint64_t r = first + i;
+            size_t n = layout.plainSize(r);
+            const unsigned char * record = data + (layout.sealedStart(r) - layout.sealedStart(first));
+            unsigned char iv[16];
+            Gcm gcm(cipher);
+
+            recordIv(header, r, iv);
+            if( !gcm.verify(iv, 16, header, headerSize, record, n, record + n) ) ok = false;
+        });
+        return ok.load();
+    });
+}
+
+template<int KeyBits>
+static bool unseal(const unsigned char * key, const unsigned char header[headerSize], const Layout & layout, int in, int out, ThreadPool & pool)
+{
+    Cipher<KeyBits> cipher(key);
+
+    return forEachWindow(layout, in, true, [&](uint64_t first, uint64_t last, const unsigned char * data) {
+        std::atomic<bool> ok(true);
+        uint64_t start = layout.plainStart(first);
+        size_t length = layout.plainStart(last - 1) + layout.plainSize(last - 1) - start;
+
+        bool mapped = withOutput(out, start, length, [&](unsigned char * plaintext) {
+            pool.run(last - first, [&](size_t i) {
+                // The input may have changed since verifyAll(), so records
+                // are decrypted privately and only copied out once their tag
+                // checks again.
+                static thread_local std::vector<unsigned char> scratch(recordSize);
+                uint64_t r = first + i;
+                size_t n = layout.plainSize(r);
+                const unsigned char * record = data + (layout.sealedStart(r) - layout.sealedStart(first));
+                unsigned char iv[16];
+                Gcm gcm(cipher);
+
+                recordIv(header, r, iv);
+                if( gcm.decrypt(iv, 16, header, headerSize, record, scratch.data(), n, record + n) ) {
+                    if( n > 0 ) memcpy(plaintext + (layout.plainStart(r) - start), scratch.data(), n);
+                } else {
+                    ok = false;
+                }
+                secure_zero(scratch.data(), n);
+            });
+        });
+
+        return mapped && ok.load();
+    });
+}
+
+// Reads the key as 32, 48 or 64 hex digits from a file, or from stdin for
+// "-", so it never appears in the process list or shell history.
+static bool readKey(const char * path, unsigned char key[32], size_t & length)
+{
+    char text[130];
+    int fd = strcmp(path, "-") == 0 ? 0 : ::open(path, O_RDONLY);
+    if( fd < 0 ) return false;
+
+    size_t size = 0;
+    ssize_t n;
+    while( size < sizeof(text) && (n = read(fd, text + size, sizeof(text) - size)) > 0 ) size += n;
+    if( fd != 0 ) close(fd);
+
+    while( size > 0 && (text[size - 1] == '\n' || text[size - 1] == '\r' || text[size - 1] == ' ') ) size--;
+
+    bool ok = size % 2 == 0 && (size == 32 || size == 48 || size == 64);
+    length = size / 2;
+    for(size_t i = 0; ok && i < length; i++) {
+        char byte[3] = { text[2 * i], text[2 * i + 1], 0 };
+        char * end;
+        key[i] = strtoul(byte, &end, 16);
+        ok = *end == 0 && isxdigit((unsigned char) byte[0]);
+    }
+
+    secure_zero(text, sizeof(text));
+    return ok;
+}
+
+static bool parseThreads(const char * text, unsigned int & threads)
+{
+    char * end;
+    errno = 0;
+    unsigned long n = strtoul(text, &end, 10);
+    if( errno != 0 || end == text || *end != 0 || text[0] == '-' || n < 1 || n > 1024 ) return false;
+    threads = n;
+    return true;
+}
+
+static bool readHeader(int in, uint64_t inSize, unsigned char header[headerSize], uint64_t & length)
+{
+    if( inSize < headerSize || pread(in, header, headerSize, 0) != (ssize_t) headerSize ) return false;
+    if( memcmp(header, magic, 8) != 0 ) return false;
+    for(int i = 20; i < 24; i++) if( header[i] != 0 ) return false;
+
+    length = 0;
+    for(int i = 0; i < 8; i++) length = (length << 8) | header[24 + i];
+    if( length > inSize || Layout(length).records > ((uint64_t) 1 << 32) ) return false;
+    return Layout(length).sealedSize() == inSize;
+}
+
+template<int KeyBits>
+static int run(bool encrypting, const unsigned char * key, int in, uint64_t inSize, const char * target, unsigned int threads)
+{
+    ThreadPool pool(threads);
+    unsigned char header[headerSize];
+    uint64_t length = 0;
+
+    if( !encrypting ) {
+        if( !readHeader(in, inSize, header, length) ) {
+            std::cerr << "input is not a sealed file or is truncated" << std::endl;
+            return 1;
+        }
+        Cipher<KeyBits> cipher(key);
+        if( !verifyAll(cipher, header, Layout(length), in, pool) ) {
+            std::cerr << "authentication failed: wrong key or modified file" << std::endl;
+            return 1;
+        }
+    }
+
+    uint64_t outSize = encrypting ? Layout(inSize).sealedSize() : length;
+    std::string temporary = std::string(target) + ".XXXXXX";
+    int out = mkstemp(&temporary[0]);
+    if( out < 0 ) {
+        std::cerr << "cannot create a temporary file next to " << target << std::endl;
+        return 1;
+    }
+
+    // Reserving the blocks up front turns a full disk into an error here
+    // instead of SIGBUS on a store into the mapping.
+    bool ok = outSize == 0 || posix_fallocate(out, 0, outSize) == 0;
+    if( !ok ) std::cerr << "cannot reserve " << outSize << " bytes for " << target << std::endl;
+
+    if( ok ) ok = encrypting ? seal<KeyBits>(key, in, out, inSize, pool) : unseal<KeyBits>(key, header, Layout(length), in, out, pool);
+
+    // Writeback was only started per window; wait for it before renaming.
+    ok = ok && fsync(out) == 0;
+    close(out);
+    ok = ok && rename(temporary.c_str(), target) == 0;
+
+    if( !ok ) {
+        unlink(temporary.c_str());
+        std::cerr << (encrypting ? "encryption" : "decryption") << " failed" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char ** argv)
+{
+    if( argc < 5 || argc > 6 || (strcmp(argv[1], "encrypt") != 0 && strcmp(argv[1], "decrypt") != 0) ) {
+        std::cerr << "usage: " << argv[0] << " encrypt|decrypt <key file|-> <input> <output> [threads]" << std::endl;
+        return 2;
+    }
+
+    bool encrypting = strcmp(argv[1], "encrypt") == 0;
+
+    unsigned int threads = std::thread::hardware_concurrency();
+    if( threads == 0 ) threads = 1;
+    if( argc > 5 && !parseThreads(argv[5], threads) ) {
+        std::cerr << "threads must be a number from 1 to 1024" << std::endl;
+        return 2;
+    }
+
+    unsigned char key[32];
+    size_t keyLength;
+    if( !readKey(argv[2], key, keyLength) ) {
+        secure_zero(key, sizeof(key));
+        std::cerr << "the key file must hold 32, 48 or 64 hex digits" << std::endl;
+        return 2;
+    }
+
+    // Refuse to touch data if the engine in use gets known answers wrong.
+    if( !startupTest(selectEngine(Engine::Auto)) ) {
+        std::cerr << "AES self-test failed" << std::endl;
+        return 1;
+    }
+
+    int in = ::open(argv[3], O_RDONLY);
+    struct stat st;
+    if( in < 0 || fstat(in, &st) != 0 || !S_ISREG(st.st_mode) ) {
+        std::cerr << "cannot open regular file " << argv[3] << std::endl;
+        return 1;
+    }
+
+    struct stat target;
+    if( stat(argv[4], &target) == 0 && target.st_dev == st.st_dev && target.st_ino == st.st_ino ) {
+        std::cerr << "input and output are the same file" << std::endl;
+        return 2;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int status;
+    if( keyLength == 16 ) status = run<128>(encrypting, key, in, st.st_size, argv[4], threads);
+    else if( keyLength == 24 ) status = run<192>(encrypting, key, in, st.st_size, argv[4], threads);
+    else status = run<256>(encrypting, key, in, st.st_size, argv[4], threads);
+    secure_zero(key, sizeof(key));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    close(in);
+
+    if( status == 0 ) {
+        std::cerr << st.st_size << " bytes in " << seconds << " s (" << st.st_size / seconds / 1e6 << " MB/s)" << std::endl;
+    }
+    return status;
+}
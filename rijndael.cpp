@@ -1,498 +1,630 @@
 #include "rijndael.h"
-#include <iostream>
-#include <vector>
+#include "rijndael_aesni.h"
+#include "rijndael_bitslice.h"
+#include "rijndael_internal.h"
+#include "rijndael_stats.h"
 #include <stdint.h>
 
 namespace Rijndael
 {
 
-    static const unsigned char sboxTable[256] = {
-        0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5,
-        0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
-        0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0,
-        0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
-        0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC,
-        0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
-        0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A,
-        0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
-        0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0,
-        0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
-        0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B,
-        0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
-        0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85,
-        0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
-        0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5,
-        0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
-        0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17,
-        0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
-        0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88,
-        0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
-        0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C,
-        0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
-        0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9,
-        0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
-        0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6,
-        0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
-        0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E,
-        0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
-        0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94,
-        0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
-        0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68,
-        0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
-    };
-
-	static const unsigned char reverseSboxTable[256] = {
-        0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38,
-        0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
-        0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87,
-        0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB,
-        0x54, 0x7B, 0x94, 0x32, 0xA6, 0xC2, 0x23, 0x3D,
-        0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
-        0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2,
-        0x76, 0x5B, 0xA2, 0x49, 0x6D, 0x8B, 0xD1, 0x25,
-        0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16,
-        0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92,
-        0x6C, 0x70, 0x48, 0x50, 0xFD, 0xED, 0xB9, 0xDA,
-        0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
-        0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A,
-        0xF7, 0xE4, 0x58, 0x05, 0xB8, 0xB3, 0x45, 0x06,
-        0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02,
-        0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B,
-        0x3A, 0x91, 0x11, 0x41, 0x4F, 0x67, 0xDC, 0xEA,
-        0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
-        0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85,
-        0xE2, 0xF9, 0x37, 0xE8, 0x1C, 0x75, 0xDF, 0x6E,
-        0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89,
-        0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B,
-        0xFC, 0x56, 0x3E, 0x4B, 0xC6, 0xD2, 0x79, 0x20,
-        0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
-        0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31,
-        0xB1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xEC, 0x5F,
-        0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D,
-        0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF,
-        0xA0, 0xE0, 0x3B, 0x4D, 0xAE, 0x2A, 0xF5, 0xB0,
-        0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
-        0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26,
-        0xE1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0C, 0x7D
-    };
-
-    static const unsigned char rconTable[256] = {
-        0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 
-        0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 
-        0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 
-        0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 
-        0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 
-        0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 
-        0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 
-        0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 
-        0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 
-        0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 
-        0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 0xc6, 0x97, 0x35, 
-        0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 0x61, 0xc2, 0x9f, 
-        0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d, 0x01, 0x02, 0x04, 
-        0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x6c, 0xd8, 0xab, 0x4d, 0x9a, 0x2f, 0x5e, 0xbc, 0x63, 
-        0xc6, 0x97, 0x35, 0x6a, 0xd4, 0xb3, 0x7d, 0xfa, 0xef, 0xc5, 0x91, 0x39, 0x72, 0xe4, 0xd3, 0xbd, 
-        0x61, 0xc2, 0x9f, 0x25, 0x4a, 0x94, 0x33, 0x66, 0xcc, 0x83, 0x1d, 0x3a, 0x74, 0xe8, 0xcb, 0x8d
-    };
-
-    uint8_t gmul(uint8_t a, uint8_t b)
+    // Every table below is computed by the compiler from the field
+    // GF(2^8) = GF(2)[x] / (x^8 + x^4 + x^3 + x + 1) and lands in read-only
+    // data; nothing is built at startup.
+    static constexpr uint8_t gmul(uint8_t a, uint8_t b)
     {
         uint8_t p = 0;
-        uint8_t counter;
-        uint8_t hi_bit_set;
-        for (counter = 0; counter < 8; counter++) {
-            if (b & 1) p ^= a;
-            hi_bit_set = (a & 0x80);
+        for(int counter = 0; counter < 8; counter++) {
+            if( b & 1 ) p ^= a;
+            bool hiBitSet = a & 0x80;
             a <<= 1;
-            if (hi_bit_set) a ^= 0x1b;
+            if( hiBitSet ) a ^= 0x1b;
             b >>= 1;
         }
         return p;
     }
 
-    void Cipher::_keyExpansion(Block key)
+    // a^254 = a^-1 for a != 0, and 0 for 0 as the S-box wants.
+    static constexpr uint8_t ginverse(uint8_t a)
     {
-        _keychain[0] = key;
+        uint8_t result = 1;
+        for(int e = 254; e > 0; e >>= 1) {
+            if( e & 1 ) result = gmul(result, a);
+            a = gmul(a, a);
+        }
+        return result;
+    }
 
-        for(int r = 1; r <= 10; r++) {
+    static constexpr uint8_t rotl8(uint8_t b, int n) { return (uint8_t)((b << n) | (b >> (8 - n))); }
+
+    // S[x] is the FIPS-197 affine map of x^-1; rcon[i] = x^(i-1), so rcon[0]
+    // is x^-1.
+    struct SboxTables
+    {
+        unsigned char sbox[256] = {};
+        unsigned char inverse[256] = {};
+        unsigned char rcon[11] = {};
+
+        constexpr SboxTables()
+        {
+            for(int x = 0; x < 256; x++) {
+                uint8_t b = ginverse(x);
+                uint8_t s = b ^ rotl8(b, 1) ^ rotl8(b, 2) ^ rotl8(b, 3) ^ rotl8(b, 4) ^ 0x63;
+                sbox[x] = s;
+                inverse[s] = x;
+            }
 
-            Block rKey;
+            rcon[0] = ginverse(2);
+            rcon[1] = 1;
+            for(int i = 2; i < 11; i++) rcon[i] = gmul(rcon[i - 1], 2);
+        }
+    };
 
-            unsigned char c[4];
-            c[0] = _keychain[r-1].get(0, 3);
-            c[1] = _keychain[r-1].get(1, 3);
-            c[2] = _keychain[r-1].get(2, 3);
-            c[3] = _keychain[r-1].get(3, 3);
+    static constexpr SboxTables sboxTables;
+    static constexpr const unsigned char (&sboxTable)[256] = sboxTables.sbox;
+    static constexpr const unsigned char (&reverseSboxTable)[256] = sboxTables.inverse;
+    static constexpr const unsigned char (&rconTable)[11] = sboxTables.rcon;
 
-            unsigned char temp = c[0];
-            c[0] = c[1];
-            c[1] = c[2];
-            c[2] = c[3];
-            c[3] = temp;
+    static constexpr bool sboxesInvert()
+    {
+        for(int x = 0; x < 256; x++) if( reverseSboxTable[sboxTable[x]] != x ) return false;
+        return true;
+    }
 
-            for(int i = 0; i < 4; i++) {
-                unsigned char low  = c[i] & 15;
-                unsigned char high = c[i] >> 4;
-                c[i] = sboxTable[high * 16 + low];
-            }
+    static_assert(sboxTable[0x00] == 0x63 && sboxTable[0x53] == 0xed && sboxTable[0xff] == 0x16, "S-box does not match FIPS-197");
+    static_assert(sboxesInvert(), "inverse S-box does not invert the S-box");
+    static_assert(rconTable[0] == 0x8d && rconTable[9] == 0x1b && rconTable[10] == 0x36, "round constants do not match FIPS-197");
 
-            rKey.set(0, 0, _keychain[r-1].get(0, 0) ^ c[0] ^ rconTable[r]);
-            rKey.set(1, 0, _keychain[r-1].get(1, 0) ^ c[1] ^ 0x00);
-            rKey.set(2, 0, _keychain[r-1].get(2, 0) ^ c[2] ^ 0x00);
-            rKey.set(3, 0, _keychain[r-1].get(3, 0) ^ c[3] ^ 0x00);
-
-            for(int i = 1; i < 4; i++) {
-                c[0] = rKey.get(0, i-1);
-                c[1] = rKey.get(1, i-1);
-                c[2] = rKey.get(2, i-1);
-                c[3] = rKey.get(3, i-1);
-                rKey.set(0, i, _keychain[r-1].get(0, i) ^ c[0]);
-                rKey.set(1, i, _keychain[r-1].get(1, i) ^ c[1]);
-                rKey.set(2, i, _keychain[r-1].get(2, i) ^ c[2]);
-                rKey.set(3, i, _keychain[r-1].get(3, i) ^ c[3]);
+    // Round tables for the TTable engine. Te0[x] holds column (2, 1, 1, 3) * S[x]
+    // and Td0[x] holds column (14, 9, 13, 11) * S'[x]; Te1-3/Td1-3 are the same
+    // words rotated by one, two and three bytes. Between them they are the
+    // multiply-by-2, 3, 9, 11, 13 and 14 tables of MixColumns and its inverse.
+    struct RoundTables
+    {
+        uint32_t te[4][256] = {};
+        uint32_t td[4][256] = {};
+
+        constexpr RoundTables()
+        {
+            for(int x = 0; x < 256; x++) {
+                uint8_t s  = sboxTable[x];
+                uint8_t is = reverseSboxTable[x];
+                uint32_t e = ((uint32_t)gmul(s, 2) << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | gmul(s, 3);
+                uint32_t d = ((uint32_t)gmul(is, 14) << 24) | ((uint32_t)gmul(is, 9) << 16) | ((uint32_t)gmul(is, 13) << 8) | gmul(is, 11);
+                for(int i = 0; i < 4; i++) {
+                    te[i][x] = e;
+                    td[i][x] = d;
+                    e = (e >> 8) | (e << 24);
+                    d = (d >> 8) | (d << 24);
+                }
             }
+        }
+    };
 
-            _keychain[r] = rKey;
+    static constexpr RoundTables roundTables;
 
-        }
+    static_assert(roundTables.te[0][0] == 0xc66363a5 && roundTables.td[0][0] == 0x51f4a750, "round tables do not match FIPS-197");
+
+    static inline uint32_t blockColumn(const Block & block, int y)
+    {
+        return ((uint32_t)block.get(0, y) << 24) | ((uint32_t)block.get(1, y) << 16) | ((uint32_t)block.get(2, y) << 8) | block.get(3, y);
     }
 
-    Block Cipher::_subBytes(Block state)
+    // Column words hold row 0 in their first byte in memory.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static const uint32_t rowMasks[4] = { 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff };
+    static inline uint32_t rotateRows(uint32_t w, int n) { return n == 0 ? w : (w << (8 * n)) | (w >> (32 - 8 * n)); }
+#else
+    static const uint32_t rowMasks[4] = { 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 };
+    static inline uint32_t rotateRows(uint32_t w, int n) { return n == 0 ? w : (w >> (8 * n)) | (w << (32 - 8 * n)); }
+#endif
+
+    // SubWord through the bitsliced S-box circuit, one byte per bit of each
+    // plane. Nothing is indexed by key bytes, so expanding a key leaks
+    // nothing through the cache whatever engine the Cipher uses.
+    static inline uint32_t subWord(uint32_t w)
     {
-        unsigned char low;
-        unsigned char high;
+        const unsigned char * b = (const unsigned char *) &w;
+        Bitslice::Lanes64 q[8];
 
-        for(int x = 0; x < 4; x++) {
-            for(int y = 0; y < 4; y++) {
-                low  = state.get(x, y) & 15;
-                high = state.get(x, y) >> 4;
-                state.set(x, y, sboxTable[high * 16 + low]);
-            }
+        for(int i = 0; i < 8; i++) {
+            q[i].v = 0;
+            for(int j = 0; j < 4; j++) q[i].v |= (uint64_t)((b[j] >> i) & 1) << j;
         }
 
-        return state;
+        Bitslice::subBytes(q);
+
+        uint32_t out;
+        unsigned char * o = (unsigned char *) &out;
+        for(int j = 0; j < 4; j++) {
+            o[j] = 0;
+            for(int i = 0; i < 8; i++) o[j] |= ((q[i].v >> j) & 1) << i;
+        }
+        return out;
     }
 
-    Block Cipher::_reverseSubBytes(Block state)
+    Engine selectEngine(Engine requested)
     {
-        unsigned char low;
-        unsigned char high;
+        if( requested == Engine::Auto ) return AesNi::available() ? Engine::AesNi : Engine::TTable;
+        if( requested == Engine::AesNi && !AesNi::available() ) return Engine::TTable;
+        return requested;
+    }
 
-        for(int x = 0; x < 4; x++) {
-            for(int y = 0; y < 4; y++) {
-                low  = state.get(x, y) & 15;
-                high = state.get(x, y) >> 4;
-                state.set(x, y, reverseSboxTable[high * 16 + low]);
+    template<int KeyBits>
+    void Cipher<KeyBits>::_keyExpansion(const uint8_t * key)
+    {
+        RIJNDAEL_TIME(KeyExpansion);
+        RIJNDAEL_COUNT(KeyExpansions, 1);
+
+        if constexpr( KeyBits != 192 ) {
+            if( _engine == Engine::AesNi ) {
+                if constexpr( KeyBits == 128 ) AesNi::expandKey128(key, _roundKeys);
+                else AesNi::expandKey256(key, _roundKeys);
+                AesNi::inverseKeys<rounds>(_roundKeys, _inverseRoundKeys);
+                for(int r = 0; r <= rounds; r++) _keychain[r] = Block::load(_roundKeys[r]);
+                return;
             }
         }
 
-        return state;
-    }
+        // FIPS-197 KeyExpansion over the Nk key words.
+        const int nk = KeyBits / 32;
+        uint32_t w[4 * (rounds + 1)];
 
-    Block Cipher::_shiftRows(Block state)
-    {
-        unsigned char temp;
+        memcpy(w, key, keyBytes);
+
+        for(int i = nk; i < 4 * (rounds + 1); i++) {
+            uint32_t t = w[i - 1];
 
-        for(int i = 1; i < 4; i++) {
-            for(int j = 0; j < i; j++) {
-                temp = state.get(i, 0);
-                state.set(i, 0, state.get(i, 1));
-                state.set(i, 1, state.get(i, 2));
-                state.set(i, 2, state.get(i, 3));
-                state.set(i, 3, temp);
+            if( i % nk == 0 || (nk > 6 && i % nk == 4) ) {
+                // RotWord and Rcon only apply at the start of each key length.
+                if( i % nk == 0 ) t = rotateRows(t, 1);
+                t = subWord(t);
+                if( i % nk == 0 ) t ^= rowMasks[0] & (0x01010101u * rconTable[i / nk]);
             }
+
+            w[i] = w[i - nk] ^ t;
         }
 
-        return state;
+        memcpy(_roundKeys, w, sizeof(w));
+        for(int r = 0; r <= rounds; r++) _keychain[r] = Block::load(_roundKeys[r]);
+        secure_zero(w, sizeof(w));
+        // Only the TTable engine reads these, and filling them does table
+        // lookups on round-key bytes.
+        if( _engine == Engine::TTable ) _tableKeyExpansion();
+        if( _engine == Engine::AesNi ) AesNi::inverseKeys<rounds>(_roundKeys, _inverseRoundKeys);
+        if( _engine == Engine::Bitsliced ) Bitslice::expandKey(_roundKeys, rounds, _bitslicedKeys);
     }
 
-    Block Cipher::_reverseShiftRows(Block state)
+    template<int KeyBits>
+    Cipher<KeyBits>::~Cipher()
     {
-        unsigned char temp;
+        secure_zero(_keychain, sizeof(_keychain));
+        secure_zero(_encKeys, sizeof(_encKeys));
+        secure_zero(_decKeys, sizeof(_decKeys));
+        secure_zero(_roundKeys, sizeof(_roundKeys));
+        secure_zero(_inverseRoundKeys, sizeof(_inverseRoundKeys));
+        secure_zero(_bitslicedKeys, sizeof(_bitslicedKeys));
+    }
 
-        for(int i = 1; i < 4; i++) {
-            for(int j = 0; j < i; j++) {
-                temp = state.get(i, 3);
-                state.set(i, 3, state.get(i, 2));
-                state.set(i, 2, state.get(i, 1));
-                state.set(i, 1, state.get(i, 0));
-                state.set(i, 0, temp);
-            }
-        }
+    void secure_zero(void * data, size_t length)
+    {
+        volatile unsigned char * b = (volatile unsigned char *) data;
+        while( length-- ) *b++ = 0;
+    }
 
-        return state;
+    template<int KeyBits>
+    void Cipher<KeyBits>::_subBytes(Block & state) const
+    {
+        unsigned char * b = state.bytes();
+        for(int i = 0; i < 16; i++) b[i] = sboxTable[b[i]];
     }
 
-    Block Cipher::_mixColumns(Block state)
+    template<int KeyBits>
+    void Cipher<KeyBits>::_reverseSubBytes(Block & state) const
     {
-        for(int y = 0; y < 4; y++) {
+        unsigned char * b = state.bytes();
+        for(int i = 0; i < 16; i++) b[i] = reverseSboxTable[b[i]];
+    }
 
-            unsigned char r[4];
-            r[0] = state.get(0, y);
-            r[1] = state.get(1, y);
-            r[2] = state.get(2, y);
-            r[3] = state.get(3, y);
-            unsigned char a[4];
-            unsigned char b[4];
-            unsigned char h;
-
-            for(unsigned char c = 0; c < 4; c++) {
-                    a[c] = r[c];
-                    h = (unsigned char)((signed char)r[c] >> 7);
-                    b[c] = r[c] << 1;
-                    b[c] ^= 0x1B & h;
-            }
+    // Row x moves x columns to the left: column y takes row x from column y + x.
+    template<int KeyBits>
+    void Cipher<KeyBits>::_shiftRows(Block & state) const
+    {
+        uint32_t * w = state.words();
+        uint32_t c[4] = { w[0], w[1], w[2], w[3] };
 
-            r[0] = b[0] ^ a[3] ^ a[2] ^ b[1] ^ a[1]; /* 2 * a0 + a3 + a2 + 3 * a1 */
-            r[1] = b[1] ^ a[0] ^ a[3] ^ b[2] ^ a[2]; /* 2 * a1 + a0 + a3 + 3 * a2 */
-            r[2] = b[2] ^ a[1] ^ a[0] ^ b[3] ^ a[3]; /* 2 * a2 + a1 + a0 + 3 * a3 */
-            r[3] = b[3] ^ a[2] ^ a[1] ^ b[0] ^ a[0]; /* 2 * a3 + a2 + a1 + 3 * a0 */
+        for(int y = 0; y < 4; y++) {
+            w[y] = (c[y] & rowMasks[0]) | (c[(y + 1) & 3] & rowMasks[1]) |
+                   (c[(y + 2) & 3] & rowMasks[2]) | (c[(y + 3) & 3] & rowMasks[3]);
+        }
+    }
 
-            state.set(0, y, r[0]);
-            state.set(1, y, r[1]);
-            state.set(2, y, r[2]);
-            state.set(3, y, r[3]);
+    template<int KeyBits>
+    void Cipher<KeyBits>::_reverseShiftRows(Block & state) const
+    {
+        uint32_t * w = state.words();
+        uint32_t c[4] = { w[0], w[1], w[2], w[3] };
 
+        for(int y = 0; y < 4; y++) {
+            w[y] = (c[y] & rowMasks[0]) | (c[(y + 3) & 3] & rowMasks[1]) |
+                   (c[(y + 2) & 3] & rowMasks[2]) | (c[(y + 1) & 3] & rowMasks[3]);
         }
+    }
 
-        return state;
+    // Multiplies each byte of a word by x (i.e. 2) in GF(2^8).
+    static inline uint32_t xtimeWord(uint32_t w)
+    {
+        return ((w & 0x7f7f7f7f) << 1) ^ (((w >> 7) & 0x01010101) * 0x1b);
     }
 
-    Block Cipher::_reverseMixColumns(Block state)
+    // b_x = 2 * a_x + 3 * a_x+1 + a_x+2 + a_x+3
+    //     = 2 * (a_x + a_x+1) + a_x+1 + a_x+2 + a_x+3
+    template<int KeyBits>
+    void Cipher<KeyBits>::_mixColumns(Block & state) const
     {
+        uint32_t * w = state.words();
+
         for(int y = 0; y < 4; y++) {
+            uint32_t a1 = rotateRows(w[y], 1);
+            w[y] = xtimeWord(w[y] ^ a1) ^ a1 ^ rotateRows(w[y], 2) ^ rotateRows(w[y], 3);
+        }
+    }
 
-            unsigned char r[4];
-            r[0] = state.get(0, y);
-            r[1] = state.get(1, y);
-            r[2] = state.get(2, y);
-            r[3] = state.get(3, y);
-            unsigned char a[4];
-            unsigned char b[4];
-            unsigned char h;
-
-            for(unsigned char c = 0; c < 4; c++) {
-                    a[c] = r[c];
-                    h = (unsigned char)((signed char)r[c] >> 7);
-                    b[c] = r[c] << 3;
-                    b[c] ^= 0x1B & h;
-            }
+    // InvMixColumns = MixColumns after adding 4 * (a_x + a_x+2) to each a_x.
+    template<int KeyBits>
+    void Cipher<KeyBits>::_reverseMixColumns(Block & state) const
+    {
+        uint32_t * w = state.words();
 
-            r[0] = gmul(14, a[0]) ^ gmul(9, a[3]) ^ gmul(13, a[2]) ^ gmul(11, a[1]); /* 14 * a0 + 9 * a3 + 13 * a2 + 11 * a1 */
-            r[1] = gmul(14, a[1]) ^ gmul(9, a[0]) ^ gmul(13, a[3]) ^ gmul(11, a[2]); /* 14 * a1 + 9 * a0 + 13 * a3 + 11 * a2 */
-            r[2] = gmul(14, a[2]) ^ gmul(9, a[1]) ^ gmul(13, a[0]) ^ gmul(11, a[3]); /* 14 * a2 + 9 * a1 + 13 * a0 + 11 * a3 */
-            r[3] = gmul(14, a[3]) ^ gmul(9, a[2]) ^ gmul(13, a[1]) ^ gmul(11, a[0]); /* 14 * a3 + 9 * a2 + 13 * a1 + 11 * a0 */
+        for(int y = 0; y < 4; y++) {
+            w[y] ^= xtimeWord(xtimeWord(w[y] ^ rotateRows(w[y], 2)));
+        }
 
-            state.set(0, y, r[0]);
-            state.set(1, y, r[1]);
-            state.set(2, y, r[2]);
-            state.set(3, y, r[3]);
+        _mixColumns(state);
+    }
 
-        }
+    template<int KeyBits>
+    void Cipher<KeyBits>::_addRoundKey(Block & state, const Block & key) const
+    {
+        uint32_t * w = state.words();
+        const uint32_t * k = key.words();
 
-        return state;
+        for(int y = 0; y < 4; y++) w[y] ^= k[y];
     }
 
-    Block Cipher::_addRoundKey(Block state, Block key)
+    template<int KeyBits>
+    void Cipher<KeyBits>::_tableKeyExpansion()
     {
-        for(int i = 0; i < 4; i++) {
-            for(int j = 0; j < 4; j++) {
-                state.set(i, j, state.get(i, j) ^ key.get(i, j));
+        const uint32_t (*td)[256] = roundTables.td;
+
+        for(int r = 0; r <= rounds; r++) {
+            for(int y = 0; y < 4; y++) {
+                _encKeys[4*r + y] = blockColumn(_keychain[r], y);
             }
         }
 
-        return state;
+        // Equivalent inverse cipher: decryption round keys are applied in
+        // reverse order with InvMixColumns folded into the middle rounds.
+        for(int r = 0; r <= rounds; r++) {
+            for(int y = 0; y < 4; y++) {
+                uint32_t w = _encKeys[4*(rounds - r) + y];
+                if( r != 0 && r != rounds ) {
+                    w = td[0][sboxTable[w >> 24]] ^ td[1][sboxTable[(w >> 16) & 0xff]] ^
+                        td[2][sboxTable[(w >> 8) & 0xff]] ^ td[3][sboxTable[w & 0xff]];
+                }
+                _decKeys[4*r + y] = w;
+            }
+        }
     }
 
-    Block Cipher::encrypt(Block state)
+    static inline uint32_t loadBe32(const unsigned char * p)
     {
-        state = _addRoundKey(state, _keychain[0]);
-
-        for(int r = 1; r <= 10; r++) {
-            state = _subBytes(state);
-            state = _shiftRows(state);
-            if( r != 10 ) state = _mixColumns(state);
-            state = _addRoundKey(state, _keychain[r]);
-        }
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
 
-        return state;
+    static inline void storeBe32(unsigned char * p, uint32_t w)
+    {
+        p[0] = w >> 24; p[1] = w >> 16; p[2] = w >> 8; p[3] = w;
     }
 
-    Block Cipher::decrypt(Block state)
+    // Runs N independent blocks through the table rounds side by side so the
+    // lookups of one block overlap the latency of the others.
+    template<int Rounds, int N>
+    static inline void tableEncrypt(const uint32_t * rk, const unsigned char * in, unsigned char * out)
     {
-        for(int r = 10; r > 0; r--) {
-            state = _addRoundKey(state, _keychain[r]);
-            if( r != 10 ) state = _reverseMixColumns(state);
-            state = _reverseShiftRows(state);
-            state = _reverseSubBytes(state);
+        const uint32_t (*te)[256] = roundTables.te;
+        uint32_t s[N][4], t[N][4];
+
+        for(int b = 0; b < N; b++) {
+            for(int y = 0; y < 4; y++) s[b][y] = loadBe32(in + 16*b + 4*y) ^ rk[y];
         }
 
-        state = _addRoundKey(state, _keychain[0]);
+        for(int r = 1; r < Rounds; r++) {
+            rk += 4;
+            for(int b = 0; b < N; b++) {
+                for(int y = 0; y < 4; y++) {
+                    t[b][y] = te[0][s[b][y] >> 24] ^ te[1][(s[b][(y + 1) & 3] >> 16) & 0xff] ^
+                              te[2][(s[b][(y + 2) & 3] >> 8) & 0xff] ^ te[3][s[b][(y + 3) & 3] & 0xff] ^ rk[y];
+                }
+            }
+            for(int b = 0; b < N; b++) {
+                for(int y = 0; y < 4; y++) s[b][y] = t[b][y];
+            }
+        }
 
-        return state;
+        // Last round has no MixColumns, so only the S-box is looked up.
+        rk += 4;
+        for(int b = 0; b < N; b++) {
+            for(int y = 0; y < 4; y++) {
+                uint32_t w = ((uint32_t)sboxTable[s[b][y] >> 24] << 24) ^ ((uint32_t)sboxTable[(s[b][(y + 1) & 3] >> 16) & 0xff] << 16) ^
+                             ((uint32_t)sboxTable[(s[b][(y + 2) & 3] >> 8) & 0xff] << 8) ^ sboxTable[s[b][(y + 3) & 3] & 0xff] ^ rk[y];
+                storeBe32(out + 16*b + 4*y, w);
+            }
+        }
     }
 
-    std::string Cipher::encrypt(std::string plaintext)
+    template<int Rounds, int N>
+    static inline void tableDecrypt(const uint32_t * rk, const unsigned char * in, unsigned char * out)
     {
-        // Create C-string, padd it to be devicable by 16 bytes.
-        int s = plaintext.size();
-        while( (s % 16) != 0 ) s++;
-        char * p = new char[s];
-        strcpy(p, plaintext.c_str());
-        int i = plaintext.size();// + 1;
-        while( i < s ) {
-            p[i] = 0x00;
-            i++;
+        const uint32_t (*td)[256] = roundTables.td;
+        uint32_t s[N][4], t[N][4];
+
+        for(int b = 0; b < N; b++) {
+            for(int y = 0; y < 4; y++) s[b][y] = loadBe32(in + 16*b + 4*y) ^ rk[y];
         }
 
-        // Construct the 128bit blocks (states).
-        int blockCount = s/16;
-        std::vector<Block> blocks;
-        while( blockCount-- > 0 ) {
-            Block block;
-            for(int a = 0; a < 4; a++) {
-                for(int b = 0; b < 4; b++) {
-                    block.set(a, b, *(p++));
+        for(int r = 1; r < Rounds; r++) {
+            rk += 4;
+            for(int b = 0; b < N; b++) {
+                for(int y = 0; y < 4; y++) {
+                    t[b][y] = td[0][s[b][y] >> 24] ^ td[1][(s[b][(y + 3) & 3] >> 16) & 0xff] ^
+                              td[2][(s[b][(y + 2) & 3] >> 8) & 0xff] ^ td[3][s[b][(y + 1) & 3] & 0xff] ^ rk[y];
                 }
             }
-            blocks.push_back(block);
+            for(int b = 0; b < N; b++) {
+                for(int y = 0; y < 4; y++) s[b][y] = t[b][y];
+            }
         }
 
-        // Encrypt the each state and replace it back into the vector.
-        for(std::vector<Block>::iterator it = blocks.begin(); it < blocks.end(); it++) {
-            *it = encrypt(*it);
+        rk += 4;
+        for(int b = 0; b < N; b++) {
+            for(int y = 0; y < 4; y++) {
+                uint32_t w = ((uint32_t)reverseSboxTable[s[b][y] >> 24] << 24) ^ ((uint32_t)reverseSboxTable[(s[b][(y + 3) & 3] >> 16) & 0xff] << 16) ^
+                             ((uint32_t)reverseSboxTable[(s[b][(y + 2) & 3] >> 8) & 0xff] << 8) ^ reverseSboxTable[s[b][(y + 1) & 3] & 0xff] ^ rk[y];
+                storeBe32(out + 16*b + 4*y, w);
+            }
         }
+    }
 
-        unsigned char out[s];
-        int o = 0;
+    template<int KeyBits>
+    Block Cipher<KeyBits>::encrypt(Block state) const
+    {
+        if( _engine == Engine::Reference ) {
+            RIJNDAEL_COUNT(BlocksEncrypted, 1);
+            return _encryptReference(state);
+        }
 
-        // Create string ciphertext
-        for(std::vector<Block>::iterator it = blocks.begin(); it < blocks.end(); it++) {
-            for(int a = 0; a < 4; a++) {
-                for(int b = 0; b < 4; b++) {
-                    out[o++] = it->get(a, b);
-                }
-            }
+        encryptBlocks(state.bytes(), state.bytes(), 1);
+        return state;
+    }
+
+    template<int KeyBits>
+    Block Cipher<KeyBits>::decrypt(Block state) const
+    {
+        if( _engine == Engine::Reference ) {
+            RIJNDAEL_COUNT(BlocksDecrypted, 1);
+            return _decryptReference(state);
         }
 
-        return std::string(base64_encode(out, o));
+        decryptBlocks(state.bytes(), state.bytes(), 1);
+        return state;
     }
 
-    std::string Cipher::decrypt(std::string ciphertext)
+    static_assert(sizeof(Block) == 16, "Block arrays must be contiguous 16-byte blocks");
+
+    template<int KeyBits>
+    void Cipher<KeyBits>::encrypt(Block * states, size_t count) const
     {
-        std::vector<Block> blocks;
+        encryptBlocks((uint8_t *) states, (uint8_t *) states, count);
+    }
 
-        unsigned char * c = base64_decode(ciphertext);
-        const char * t = (char *) c;
-        unsigned int s = strlen(t);
+    template<int KeyBits>
+    void Cipher<KeyBits>::decrypt(Block * states, size_t count) const
+    {
+        decryptBlocks((uint8_t *) states, (uint8_t *) states, count);
+    }
 
-        if( (s % 16) != 0 ) return std::string("");
+    template<int KeyBits>
+    void Cipher<KeyBits>::encryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        RIJNDAEL_COUNT(BlocksEncrypted, nblocks);
+
+        switch( _engine ) {
+        case Engine::AesNi:
+            AesNi::encryptBlocks<rounds>(_roundKeys, in, out, nblocks);
+            break;
+        case Engine::Bitsliced:
+            if( in != out ) memcpy(out, in, 16 * nblocks);
+            Bitslice::encrypt<rounds>(_bitslicedKeys, out, nblocks);
+            break;
+        case Engine::TTable:
+            for(; nblocks >= 4; nblocks -= 4, in += 64, out += 64) tableEncrypt<rounds, 4>(_encKeys, in, out);
+            for(; nblocks > 0; nblocks--, in += 16, out += 16) tableEncrypt<rounds, 1>(_encKeys, in, out);
+            break;
+        default:
+            for(; nblocks > 0; nblocks--, in += 16, out += 16) {
+                _encryptReference(Block::load(in)).store(out);
+            }
+            break;
+        }
+    }
 
-        // Split up input into blocks (states).
-        int blockCount = s/16;
-        while( blockCount-- > 0 ) {
-            Block state;
-            for(int i = 0; i < 4; i++) {
-                for(int j = 0; j < 4; j++) {
-                    state.set(i, j, *(c++));
-                }
+    template<int KeyBits>
+    void Cipher<KeyBits>::decryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        RIJNDAEL_COUNT(BlocksDecrypted, nblocks);
+
+        switch( _engine ) {
+        case Engine::AesNi:
+            AesNi::decryptBlocks<rounds>(_inverseRoundKeys, in, out, nblocks);
+            break;
+        case Engine::Bitsliced:
+            if( in != out ) memcpy(out, in, 16 * nblocks);
+            Bitslice::decrypt<rounds>(_bitslicedKeys, out, nblocks);
+            break;
+        case Engine::TTable:
+            for(; nblocks >= 4; nblocks -= 4, in += 64, out += 64) tableDecrypt<rounds, 4>(_decKeys, in, out);
+            for(; nblocks > 0; nblocks--, in += 16, out += 16) tableDecrypt<rounds, 1>(_decKeys, in, out);
+            break;
+        default:
+            for(; nblocks > 0; nblocks--, in += 16, out += 16) {
+                _decryptReference(Block::load(in)).store(out);
             }
-            blocks.push_back(state);
+            break;
         }
+    }
 
-        for(std::vector<Block>::iterator it = blocks.begin(); it < blocks.end(); it++) {
-            *it = decrypt(*it);
+    template<int KeyBits>
+    Block Cipher<KeyBits>::_encryptReference(Block state) const
+    {
+        _addRoundKey(state, _keychain[0]);
+
+        for(int r = 1; r <= rounds; r++) {
+            _subBytes(state);
+            _shiftRows(state);
+            if( r != rounds ) _mixColumns(state);
+            _addRoundKey(state, _keychain[r]);
         }
 
-        std::string plaintext;
+        return state;
+    }
 
-        for(std::vector<Block>::iterator it = blocks.begin(); it < blocks.end(); it++) {
-            for(int i = 0; i < 4; i++) {
-                for(int j = 0; j < 4; j++) {
-                    plaintext += it->get(i, j);
-                }
-            }
+    template<int KeyBits>
+    Block Cipher<KeyBits>::_decryptReference(Block state) const
+    {
+        for(int r = rounds; r > 0; r--) {
+            _addRoundKey(state, _keychain[r]);
+            if( r != rounds ) _reverseMixColumns(state);
+            _reverseShiftRows(state);
+            _reverseSubBytes(state);
         }
 
-        return plaintext;
+        _addRoundKey(state, _keychain[0]);
+
+        return state;
     }
 
-    static inline bool is_base64(unsigned char c)
+    // The string API lays each 16-byte chunk into the state row by row
+    // rather than in FIPS-197 column order; transposing around the block
+    // calls keeps existing ciphertexts readable.
+    void transpose_block(unsigned char b[16])
     {
-        return (isalnum(c) || (c == '+') || (c == '/'));
+        unsigned char t;
+        t = b[1];  b[1]  = b[4];  b[4]  = t;
+        t = b[2];  b[2]  = b[8];  b[8]  = t;
+        t = b[3];  b[3]  = b[12]; b[12] = t;
+        t = b[6];  b[6]  = b[9];  b[9]  = t;
+        t = b[7];  b[7]  = b[13]; b[13] = t;
+        t = b[11]; b[11] = b[14]; b[14] = t;
     }
 
-    std::string base64_encode(unsigned char * binary, unsigned int length)
+    template<int KeyBits>
+    size_t Cipher<KeyBits>::encryptedSize(size_t length) const
     {
-        static const std::string base64_chars = 
-                     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                     "abcdefghijklmnopqrstuvwxyz"
-                     "0123456789+/";
+        return base64_encoded_size((length + 15) / 16 * 16);
+    }
 
-        std::string ret;
-        int i = 0;
-        int j = 0;
-        unsigned char char_array_3[3];
-        unsigned char char_array_4[4];
-        while (length--) {
-            char_array_3[i++] = *(binary++);
-            if (i == 3) {
-                char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-                char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-                char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-                char_array_4[3] = char_array_3[2] & 0x3f;
-                for(i = 0; (i <4) ; i++) ret += base64_chars[char_array_4[i]];
-                i = 0;
-            }
-        }
-        if(i) {
-            for(j = i; j < 3; j++) char_array_3[j] = '\0';
-            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-            char_array_4[3] = char_array_3[2] & 0x3f;
-            for (j = 0; (j < i + 1); j++) ret += base64_chars[char_array_4[j]];
-            while((i++ < 3)) ret += '=';
-        }
-        return ret;
-    }
-
-    unsigned char * base64_decode(std::string base64)
-    {
-        static const std::string base64_chars = 
-                     "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                     "abcdefghijklmnopqrstuvwxyz"
-                     "0123456789+/";
-
-        int in_len = base64.size();
-        int i = 0;
-        int j = 0;
-        int in_ = 0;
-        unsigned char char_array_4[4], char_array_3[3];
-        std::string ret;
-        while (in_len-- && ( base64[in_] != '=') && is_base64(base64[in_])) {
-            char_array_4[i++] = base64[in_]; in_++;
-            if(i == 4) {
-                for (i = 0; i <4; i++) char_array_4[i] = base64_chars.find(char_array_4[i]);
-                char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-                char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-                char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-                for (i = 0; (i < 3); i++) ret += char_array_3[i];
-                i = 0;
-            }
+    template<int KeyBits>
+    size_t Cipher<KeyBits>::decryptedSize(size_t length) const
+    {
+        return base64_decoded_size(length);
+    }
+
+    template<int KeyBits>
+    size_t Cipher<KeyBits>::encrypt(std::string_view plaintext, char * out) const
+    {
+        RIJNDAEL_TIME(StringEncrypt);
+        RIJNDAEL_COUNT(StringBytes, plaintext.size());
+
+        // 48 blocks is a multiple of three bytes, so chunks base64-encode
+        // back to back without padding in between.
+        unsigned char buffer[48 * 16];
+        const char * in = plaintext.data();
+        size_t remaining = plaintext.size();
+        char * o = out;
+
+        while( remaining > 0 ) {
+            size_t n = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+            size_t blocks = (n + 15) / 16;
+
+            memcpy(buffer, in, n);
+            memset(buffer + n, 0, 16 * blocks - n);
+            for(size_t b = 0; b < blocks; b++) transpose_block(buffer + 16 * b);
+            encryptBlocks(buffer, buffer, blocks);
+            for(size_t b = 0; b < blocks; b++) transpose_block(buffer + 16 * b);
+            o += base64_encode(buffer, 16 * blocks, o);
+
+            in += n;
+            remaining -= n;
         }
-        if(i) {
-            for (j = i; j <4; j++) char_array_4[j] = 0;
-            for (j = 0; j <4; j++) char_array_4[j] = base64_chars.find(char_array_4[j]);
-            char_array_3[0] = (char_array_4[0] << 2) + ((char_array_4[1] & 0x30) >> 4);
-            char_array_3[1] = ((char_array_4[1] & 0xf) << 4) + ((char_array_4[2] & 0x3c) >> 2);
-            char_array_3[2] = ((char_array_4[2] & 0x3) << 6) + char_array_4[3];
-            for (j = 0; (j < i - 1); j++) ret += char_array_3[j];
+
+        secure_zero(buffer, sizeof(buffer));
+        return o - out;
+    }
+
+    template<int KeyBits>
+    void Cipher<KeyBits>::encrypt(std::string_view plaintext, std::string & out) const
+    {
+        out.resize(encryptedSize(plaintext.size()));
+        encrypt(plaintext, &out[0]);
+    }
+
+    template<int KeyBits>
+    bool Cipher<KeyBits>::decrypt(std::string_view ciphertext, unsigned char * out, size_t & length) const
+    {
+        RIJNDAEL_TIME(StringDecrypt);
+        RIJNDAEL_COUNT(StringBytes, ciphertext.size());
+
+        if( !base64_decode(ciphertext.data(), ciphertext.size(), out, length) || (length % 16) != 0 ) {
+            length = 0;
+            return false;
         }
-        char * str = new char[ret.size()];
-        strcpy(str, ret.c_str());
-        return (unsigned char *) str;
+
+        for(size_t b = 0; b < length / 16; b++) transpose_block(out + 16 * b);
+        decryptBlocks(out, out, length / 16);
+        for(size_t b = 0; b < length / 16; b++) transpose_block(out + 16 * b);
+
+        return true;
     }
 
-};
+    template<int KeyBits>
+    bool Cipher<KeyBits>::decrypt(std::string_view ciphertext, std::string & out) const
+    {
+        size_t length;
+        out.resize(decryptedSize(ciphertext.size()));
+        bool ok = decrypt(ciphertext, (unsigned char *) &out[0], length);
+        out.resize(length);
+        return ok;
+    }
 
+    template<int KeyBits>
+    std::string Cipher<KeyBits>::encrypt(const std::string & plaintext) const
+    {
+        std::string ciphertext;
+        encrypt(std::string_view(plaintext), ciphertext);
+        return ciphertext;
+    }
+
+    template<int KeyBits>
+    std::string Cipher<KeyBits>::decrypt(const std::string & ciphertext) const
+    {
+        std::string plaintext;
+        decrypt(std::string_view(ciphertext), plaintext);
+        return plaintext;
+    }
+
+    template class Cipher<128>;
+    template class Cipher<192>;
+    template class Cipher<256>;
+
+};
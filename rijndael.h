@@ -2,43 +2,190 @@
 #define RIJNDAEL_H
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <cstring>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace Rijndael
 {
 
-    class Block
+    // 16-byte aligned AES state in FIPS-197 column order: byte x + 4 * y is
+    // row x of column y, and word y is column y in native byte order. An
+    // array of Blocks is therefore a plain buffer of contiguous blocks.
+    class alignas(16) Block
     {
     protected:
-        unsigned char _grid[4][4];
+        union {
+            unsigned char _bytes[16];
+            uint32_t _words[4];
+#ifdef __SSE2__
+            __m128i _vector;
+#endif
+        };
 
     public:
-        unsigned char get(unsigned char x, unsigned char y) { return _grid[x][y]; }
-        void set(unsigned char x, unsigned char y, unsigned char v) { _grid[x][y] = v; }
+        unsigned char get(unsigned char x, unsigned char y) const { return _bytes[x + 4 * y]; }
+        void set(unsigned char x, unsigned char y, unsigned char v) { _bytes[x + 4 * y] = v; }
+
+        unsigned char * bytes() { return _bytes; }
+        const unsigned char * bytes() const { return _bytes; }
+        uint32_t * words() { return _words; }
+        const uint32_t * words() const { return _words; }
+#ifdef __SSE2__
+        __m128i & vector() { return _vector; }
+        const __m128i & vector() const { return _vector; }
+#endif
+
+        static Block load(const unsigned char * bytes) { Block b; memcpy(b._bytes, bytes, 16); return b; }
+        void store(unsigned char * bytes) const { memcpy(bytes, _bytes, 16); }
+    };
+
+    // Round implementation used by Cipher::encrypt/decrypt(Block). All
+    // engines produce identical output; Reference is the byte-wise path
+    // straight from FIPS-197, TTable fuses SubBytes, ShiftRows and
+    // MixColumns into 32-bit table lookups and AesNi uses the AESENC/AESDEC
+    // instructions. Bitsliced evaluates the S-box as a boolean circuit over
+    // 8 (SSE2) or 16 (AVX2) blocks at once and runs in constant time; it pays
+    // off through the batch encrypt/decrypt(Block *, size_t) calls. Auto picks
+    // AesNi when the CPU has it and TTable otherwise.
+    enum class Engine
+    {
+        Reference,
+        TTable,
+        AesNi,
+        Bitsliced,
+        Auto
+    };
+
+    Engine selectEngine(Engine requested);
+
+    // Raw block interface shared by every key size, so the modes of operation
+    // (Ctr, Gcm, Encryptor, ...) take any Cipher<KeyBits>.
+    class BlockCipher
+    {
+    public:
+        virtual ~BlockCipher() {}
+        virtual Engine engine() const = 0;
+
+        // Bulk ECB over caller-owned buffers of nblocks * 16 bytes in FIPS-197
+        // byte order. in and out may be the same buffer; nothing is allocated.
+        virtual void encryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const = 0;
+        virtual void decryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const = 0;
     };
 
-    class Cipher
+    // AES with a 128, 192 or 256-bit key. The round count and every key
+    // schedule array are sized at compile time from KeyBits.
+    //
+    // The key schedule is written once in the constructor and never again,
+    // and every public method is const and keeps its scratch state on the
+    // caller's stack. One Cipher may therefore be shared by any number of
+    // threads without locking once it has been constructed.
+    template<int KeyBits = 128>
+    class Cipher : public BlockCipher
     {
+        static_assert(KeyBits == 128 || KeyBits == 192 || KeyBits == 256, "AES keys are 128, 192 or 256 bits");
+
+    public:
+        static const int keyBytes = KeyBits / 8;
+        static const int rounds = KeyBits / 32 + 6;
+
     protected:
-        Block _keychain[11];
+        Block _keychain[rounds + 1];
+        uint32_t _encKeys[4 * (rounds + 1)];
+        uint32_t _decKeys[4 * (rounds + 1)];
+        alignas(16) unsigned char _roundKeys[rounds + 1][16];
+        alignas(16) unsigned char _inverseRoundKeys[rounds + 1][16];
+        uint64_t _bitslicedKeys[8 * (rounds + 1)];
+        Engine _engine;
+
+        void  _keyExpansion(const uint8_t * key);
+        void  _tableKeyExpansion();
+        void  _subBytes(Block & state) const;
+        void  _reverseSubBytes(Block & state) const;
+        void  _shiftRows(Block & state) const;
+        void  _reverseShiftRows(Block & state) const;
+        void  _mixColumns(Block & state) const;
+        void  _reverseMixColumns(Block & state) const;
+        void  _addRoundKey(Block & state, const Block & key) const;
 
-        void  _keyExpansion(Block key);
-        Block _subBytes(Block state);
-        Block _reverseSubBytes(Block state);
-        Block _shiftRows(Block state);
-        Block _reverseShiftRows(Block state);
-        Block _mixColumns(Block state);
-        Block _reverseMixColumns(Block state);
-        Block _addRoundKey(Block state, Block key);
+        Block _encryptReference(Block state) const;
+        Block _decryptReference(Block state) const;
 
     public:
-        Cipher(Block key) { _keyExpansion(key); }
-        Block encrypt(Block state);
-        Block decrypt(Block state);
-        std::string encrypt(std::string plaintext);
-        std::string decrypt(std::string ciphertext);
+        // key holds keyBytes bytes in FIPS-197 order.
+        Cipher(const uint8_t * key, Engine engine = Engine::Auto) : _engine(selectEngine(engine)) { _keyExpansion(key); }
+
+        template<int K = KeyBits, typename = typename std::enable_if<K == 128>::type>
+        Cipher(Block key, Engine engine = Engine::Auto) : _engine(selectEngine(engine)) { _keyExpansion(key.bytes()); }
+
+        // Wipes every copy of the key schedule.
+        ~Cipher();
+
+        Engine engine() const { return _engine; }
+        Block encrypt(Block state) const;
+        Block decrypt(Block state) const;
+        void  encrypt(Block * states, size_t count) const;
+        void  decrypt(Block * states, size_t count) const;
+
+        void  encryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const;
+        void  decryptBlocks(const uint8_t * in, uint8_t * out, size_t nblocks) const;
+
+        // Base64 ECB over strings, NUL-padded to whole blocks. The string_view
+        // overloads never allocate: they write encryptedSize()/decryptedSize()
+        // bytes into the caller's buffer, or resize a reusable std::string.
+        size_t encryptedSize(size_t length) const;
+        size_t decryptedSize(size_t length) const;
+        size_t encrypt(std::string_view plaintext, char * out) const;
+        void   encrypt(std::string_view plaintext, std::string & out) const;
+        bool   decrypt(std::string_view ciphertext, unsigned char * out, size_t & length) const;
+        bool   decrypt(std::string_view ciphertext, std::string & out) const;
+        std::string encrypt(const std::string & plaintext) const;
+        std::string decrypt(const std::string & ciphertext) const;
+
+        // The same into strings with any allocator, e.g. SecureString.
+        template<class Allocator>
+        void encrypt(std::string_view plaintext, std::basic_string<char, std::char_traits<char>, Allocator> & out) const
+        {
+            out.resize(encryptedSize(plaintext.size()));
+            encrypt(plaintext, &out[0]);
+        }
+
+        template<class Allocator>
+        bool decrypt(std::string_view ciphertext, std::basic_string<char, std::char_traits<char>, Allocator> & out) const
+        {
+            size_t length;
+            out.resize(decryptedSize(ciphertext.size()));
+            bool ok = decrypt(ciphertext, (unsigned char *) &out[0], length);
+            out.resize(length);
+            return ok;
+        }
     };
 
+    // Defined in rijndael.cpp for these key sizes only.
+    extern template class Cipher<128>;
+    extern template class Cipher<192>;
+    extern template class Cipher<256>;
+
+    // Binary-safe base64 into caller-sized buffers. base64_encode writes
+    // base64_encoded_size(length) characters (no terminator). base64_decode
+    // accepts input with or without trailing padding, writes at most
+    // base64_decoded_size(length) bytes and returns false on characters
+    // outside the alphabet.
+    size_t base64_encoded_size(size_t length);
+    size_t base64_decoded_size(size_t length);
+    size_t base64_encode(const unsigned char * binary, size_t length, char * out);
+    bool base64_decode(const char * base64, size_t length, unsigned char * out, size_t & written);
+
+    // Zeroes memory in a way the compiler cannot drop, even right before
+    // the memory is freed.
+    void secure_zero(void * data, size_t length);
+
     std::string base64_encode(unsigned char *, unsigned int);
     unsigned char * base64_decode(std::string);
 
@@ -0,0 +1,191 @@
+#include "rijndael_aesni.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <wmmintrin.h>
+#define RIJNDAEL_HAVE_AESNI 1
+#endif
+
+#define RIJNDAEL_AESNI_INSTANTIATE(R) \
+    template void inverseKeys<R>(const unsigned char (*)[16], unsigned char (*)[16]); \
+    template void encrypt<R>(const unsigned char (*)[16], const unsigned char *, unsigned char *); \
+    template void decrypt<R>(const unsigned char (*)[16], const unsigned char *, unsigned char *); \
+    template void encryptBlocks<R>(const unsigned char (*)[16], const unsigned char *, unsigned char *, size_t); \
+    template void decryptBlocks<R>(const unsigned char (*)[16], const unsigned char *, unsigned char *, size_t);
+
+namespace Rijndael
+{
+namespace AesNi
+{
+
+#ifdef RIJNDAEL_HAVE_AESNI
+
+    static bool detect()
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) ) return false;
+        return (ecx & bit_AES) != 0;
+    }
+
+    bool available()
+    {
+        static const bool hasAes = detect();
+        return hasAes;
+    }
+
+    // Everything below only runs once available() said yes. The templates
+    // are compiled at their instantiation point, so the explicit
+    // instantiations stay inside the target region.
+#pragma GCC push_options
+#pragma GCC target("aes,sse2")
+
+    static inline __m128i prefixXor(__m128i key)
+    {
+        key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+        key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+        return _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    }
+
+    // Next four words from RotWord(SubWord(w3)) ^ Rcon in the top lane.
+    static inline __m128i expandStep(__m128i key, __m128i assist)
+    {
+        return _mm_xor_si128(prefixXor(key), _mm_shuffle_epi32(assist, 0xff));
+    }
+
+    // AES-256 odd steps use SubWord(w3) without rotation or Rcon.
+    static inline __m128i expandStepSub(__m128i key, __m128i previous)
+    {
+        return _mm_xor_si128(prefixXor(key), _mm_shuffle_epi32(_mm_aeskeygenassist_si128(previous, 0x00), 0xaa));
+    }
+
+    void expandKey128(const unsigned char key[16], unsigned char encKeys[11][16])
+    {
+        __m128i * ek = (__m128i *) encKeys;
+
+        // AESKEYGENASSIST takes the round constant as an immediate.
+        ek[0]  = _mm_loadu_si128((const __m128i *) key);
+        ek[1]  = expandStep(ek[0], _mm_aeskeygenassist_si128(ek[0], 0x01));
+        ek[2]  = expandStep(ek[1], _mm_aeskeygenassist_si128(ek[1], 0x02));
+        ek[3]  = expandStep(ek[2], _mm_aeskeygenassist_si128(ek[2], 0x04));
+        ek[4]  = expandStep(ek[3], _mm_aeskeygenassist_si128(ek[3], 0x08));
+        ek[5]  = expandStep(ek[4], _mm_aeskeygenassist_si128(ek[4], 0x10));
+        ek[6]  = expandStep(ek[5], _mm_aeskeygenassist_si128(ek[5], 0x20));
+        ek[7]  = expandStep(ek[6], _mm_aeskeygenassist_si128(ek[6], 0x40));
+        ek[8]  = expandStep(ek[7], _mm_aeskeygenassist_si128(ek[7], 0x80));
+        ek[9]  = expandStep(ek[8], _mm_aeskeygenassist_si128(ek[8], 0x1b));
+        ek[10] = expandStep(ek[9], _mm_aeskeygenassist_si128(ek[9], 0x36));
+    }
+
+    void expandKey256(const unsigned char key[32], unsigned char encKeys[15][16])
+    {
+        __m128i * ek = (__m128i *) encKeys;
+
+        ek[0]  = _mm_loadu_si128((const __m128i *) key);
+        ek[1]  = _mm_loadu_si128((const __m128i *) (key + 16));
+        ek[2]  = expandStep(ek[0], _mm_aeskeygenassist_si128(ek[1], 0x01));
+        ek[3]  = expandStepSub(ek[1], ek[2]);
+        ek[4]  = expandStep(ek[2], _mm_aeskeygenassist_si128(ek[3], 0x02));
+        ek[5]  = expandStepSub(ek[3], ek[4]);
+        ek[6]  = expandStep(ek[4], _mm_aeskeygenassist_si128(ek[5], 0x04));
+        ek[7]  = expandStepSub(ek[5], ek[6]);
+        ek[8]  = expandStep(ek[6], _mm_aeskeygenassist_si128(ek[7], 0x08));
+        ek[9]  = expandStepSub(ek[7], ek[8]);
+        ek[10] = expandStep(ek[8], _mm_aeskeygenassist_si128(ek[9], 0x10));
+        ek[11] = expandStepSub(ek[9], ek[10]);
+        ek[12] = expandStep(ek[10], _mm_aeskeygenassist_si128(ek[11], 0x20));
+        ek[13] = expandStepSub(ek[11], ek[12]);
+        ek[14] = expandStep(ek[12], _mm_aeskeygenassist_si128(ek[13], 0x40));
+    }
+
+    template<int Rounds>
+    void inverseKeys(const unsigned char encKeys[][16], unsigned char decKeys[][16])
+    {
+        const __m128i * ek = (const __m128i *) encKeys;
+        __m128i * dk = (__m128i *) decKeys;
+
+        dk[0] = ek[Rounds];
+        for(int r = 1; r < Rounds; r++) dk[r] = _mm_aesimc_si128(ek[Rounds - r]);
+        dk[Rounds] = ek[0];
+    }
+
+    template<int Rounds>
+    void encrypt(const unsigned char keys[][16], const unsigned char in[16], unsigned char out[16])
+    {
+        const __m128i * rk = (const __m128i *) keys;
+        __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), rk[0]);
+        for(int r = 1; r < Rounds; r++) state = _mm_aesenc_si128(state, rk[r]);
+        state = _mm_aesenclast_si128(state, rk[Rounds]);
+        _mm_storeu_si128((__m128i *) out, state);
+    }
+
+    template<int Rounds>
+    void decrypt(const unsigned char keys[][16], const unsigned char in[16], unsigned char out[16])
+    {
+        const __m128i * rk = (const __m128i *) keys;
+        __m128i state = _mm_xor_si128(_mm_loadu_si128((const __m128i *) in), rk[0]);
+        for(int r = 1; r < Rounds; r++) state = _mm_aesdec_si128(state, rk[r]);
+        state = _mm_aesdeclast_si128(state, rk[Rounds]);
+        _mm_storeu_si128((__m128i *) out, state);
+    }
+
+    // Eight blocks are kept in flight so every AESENC/AESDEC issues while the
+    // previous ones are still in the pipeline.
+    template<int Rounds>
+    void encryptBlocks(const unsigned char keys[][16], const unsigned char * in, unsigned char * out, size_t blocks)
+    {
+        const __m128i * rk = (const __m128i *) keys;
+
+        for(; blocks >= 8; blocks -= 8, in += 128, out += 128) {
+            __m128i b[8];
+            for(int i = 0; i < 8; i++) b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (in + 16 * i)), rk[0]);
+            for(int r = 1; r < Rounds; r++) {
+                for(int i = 0; i < 8; i++) b[i] = _mm_aesenc_si128(b[i], rk[r]);
+            }
+            for(int i = 0; i < 8; i++) _mm_storeu_si128((__m128i *) (out + 16 * i), _mm_aesenclast_si128(b[i], rk[Rounds]));
+        }
+
+        for(; blocks > 0; blocks--, in += 16, out += 16) encrypt<Rounds>(keys, in, out);
+    }
+
+    template<int Rounds>
+    void decryptBlocks(const unsigned char keys[][16], const unsigned char * in, unsigned char * out, size_t blocks)
+    {
+        const __m128i * rk = (const __m128i *) keys;
+
+        for(; blocks >= 8; blocks -= 8, in += 128, out += 128) {
+            __m128i b[8];
+            for(int i = 0; i < 8; i++) b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (in + 16 * i)), rk[0]);
+            for(int r = 1; r < Rounds; r++) {
+                for(int i = 0; i < 8; i++) b[i] = _mm_aesdec_si128(b[i], rk[r]);
+            }
+            for(int i = 0; i < 8; i++) _mm_storeu_si128((__m128i *) (out + 16 * i), _mm_aesdeclast_si128(b[i], rk[Rounds]));
+        }
+
+        for(; blocks > 0; blocks--, in += 16, out += 16) decrypt<Rounds>(keys, in, out);
+    }
+
+    RIJNDAEL_AESNI_INSTANTIATE(10)
+    RIJNDAEL_AESNI_INSTANTIATE(12)
+    RIJNDAEL_AESNI_INSTANTIATE(14)
+
+#pragma GCC pop_options
+
+#else
+
+    bool available() { return false; }
+    void expandKey128(const unsigned char *, unsigned char (*)[16]) {}
+    void expandKey256(const unsigned char *, unsigned char (*)[16]) {}
+    template<int Rounds> void inverseKeys(const unsigned char (*)[16], unsigned char (*)[16]) {}
+    template<int Rounds> void encrypt(const unsigned char (*)[16], const unsigned char *, unsigned char *) {}
+    template<int Rounds> void decrypt(const unsigned char (*)[16], const unsigned char *, unsigned char *) {}
+    template<int Rounds> void encryptBlocks(const unsigned char (*)[16], const unsigned char *, unsigned char *, size_t) {}
+    template<int Rounds> void decryptBlocks(const unsigned char (*)[16], const unsigned char *, unsigned char *, size_t) {}
+
+    RIJNDAEL_AESNI_INSTANTIATE(10)
+    RIJNDAEL_AESNI_INSTANTIATE(12)
+    RIJNDAEL_AESNI_INSTANTIATE(14)
+
+#endif
+
+};
+};
@@ -0,0 +1,28 @@
+#ifndef RIJNDAEL_AESNI_H
+#define RIJNDAEL_AESNI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Rijndael
+{
+
+    // AES-NI primitives. Round keys are 16-byte aligned and stored in FIPS-197
+    // byte order; the decryption schedule already has InvMixColumns applied.
+    // Rounds is 10, 12 or 14.
+    namespace AesNi
+    {
+        bool available();
+        void expandKey128(const unsigned char key[16], unsigned char encKeys[11][16]);
+        void expandKey256(const unsigned char key[32], unsigned char encKeys[15][16]);
+
+        template<int Rounds> void inverseKeys(const unsigned char encKeys[][16], unsigned char decKeys[][16]);
+        template<int Rounds> void encrypt(const unsigned char keys[][16], const unsigned char in[16], unsigned char out[16]);
+        template<int Rounds> void decrypt(const unsigned char keys[][16], const unsigned char in[16], unsigned char out[16]);
+        template<int Rounds> void encryptBlocks(const unsigned char keys[][16], const unsigned char * in, unsigned char * out, size_t blocks);
+        template<int Rounds> void decryptBlocks(const unsigned char keys[][16], const unsigned char * in, unsigned char * out, size_t blocks);
+    };
+
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "rijndael_arena.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define RIJNDAEL_HAVE_MLOCK 1
+#endif
+
+namespace Rijndael
+{
+
+    static const size_t minimumClass = 64;
+
+    int SecureArena::_sizeClass(size_t bytes)
+    {
+        int c = 0;
+        for(size_t size = minimumClass; size < bytes; size <<= 1) c++;
+        return c;
+    }
+
+    SecureArena::SecureArena(size_t bytes) : _base(0), _size(0), _used(0), _locked(false)
+    {
+        for(int c = 0; c < classCount; c++) _free[c] = 0;
+
+#ifdef RIJNDAEL_HAVE_MLOCK
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t size = (bytes + page - 1) / page * page;
+        void * base = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if( base == MAP_FAILED ) return;
+
+        _base = (unsigned char *) base;
+        _size = size;
+        _locked = mlock(_base, _size) == 0;
+#ifdef MADV_DONTDUMP
+        madvise(_base, _size, MADV_DONTDUMP);
+#endif
+#else
+        size_t size = (bytes + minimumClass - 1) / minimumClass * minimumClass;
+        _base = (unsigned char *) ::operator new(size, std::align_val_t(minimumClass), std::nothrow);
+        if( _base == 0 ) return;
+        _size = size;
+        memset(_base, 0, _size);
+#endif
+    }
+
+    SecureArena::~SecureArena()
+    {
+        if( _base == 0 ) return;
+
+        // Anything still allocated is wiped too.
+        secure_zero(_base, _size);
+#ifdef RIJNDAEL_HAVE_MLOCK
+        if( _locked ) munlock(_base, _size);
+        munmap(_base, _size);
+#else
+        ::operator delete(_base, std::align_val_t(minimumClass));
+#endif
+    }
+
+    void * SecureArena::allocate(size_t bytes)
+    {
+        int c = _sizeClass(bytes);
+        if( c >= classCount ) return 0;
+        size_t size = minimumClass << c;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Free memory is all zero apart from the list link.
+        if( _free[c] != 0 ) {
+            void * memory = _free[c];
+            _free[c] = *(void **) memory;
+            *(void **) memory = 0;
+            return memory;
+        }
+
+        if( _size - _used < size ) return 0;
+        void * memory = _base + _used;
+        _used += size;
+        return memory;
+    }
+
+    void SecureArena::deallocate(void * memory, size_t bytes)
+    {
+        if( memory == 0 ) return;
+
+        int c = _sizeClass(bytes);
+        secure_zero(memory, minimumClass << c);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        *(void **) memory = _free[c];
+        _free[c] = memory;
+    }
+
+};
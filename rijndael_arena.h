@@ -0,0 +1,92 @@
+#ifndef RIJNDAEL_ARENA_H
+#define RIJNDAEL_ARENA_H
+
+#include "rijndael.h"
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace Rijndael
+{
+
+    // Fixed-size pool of page-locked memory for key schedules and working
+    // buffers. The whole region is reserved, mlock()ed and excluded from
+    // core dumps up front, so secrets placed in it are never swapped out
+    // and steady-state use never reaches the system allocator.
+    //
+    // Requests are rounded up to a power-of-two size class of at least 64
+    // bytes (so every allocation is cache-line aligned) and carved from the
+    // region; released memory is zeroized and kept on its class's free list
+    // for reuse. allocate() returns null once the region is used up.
+    // locked() reports whether mlock succeeded; RLIMIT_MEMLOCK can refuse it,
+    // in which case the arena still works but may be paged out. All methods
+    // are thread-safe.
+    class SecureArena
+    {
+    protected:
+        static const int classCount = 48;
+
+        std::mutex _mutex;
+        unsigned char * _base;
+        size_t _size;
+        size_t _used;
+        bool _locked;
+        void * _free[classCount];
+
+        static int _sizeClass(size_t bytes);
+
+    public:
+        explicit SecureArena(size_t bytes);
+        ~SecureArena();
+
+        SecureArena(const SecureArena &) = delete;
+        SecureArena & operator=(const SecureArena &) = delete;
+
+        void * allocate(size_t bytes);
+        void deallocate(void * memory, size_t bytes);
+        bool owns(const void * memory) const { return (const unsigned char *) memory >= _base && (const unsigned char *) memory < _base + _size; }
+
+        bool locked() const { return _locked; }
+        size_t size() const { return _size; }
+    };
+
+    // Standard allocator over a SecureArena, for containers that hold
+    // plaintext or key material. Throws std::bad_alloc when the arena is
+    // exhausted. Short strings live inside the std::basic_string object
+    // itself rather than in the arena.
+    template<class T>
+    class SecureAllocator
+    {
+        template<class U> friend class SecureAllocator;
+
+    protected:
+        SecureArena * _arena;
+
+    public:
+        typedef T value_type;
+
+        SecureAllocator(SecureArena & arena) : _arena(&arena) {}
+        template<class U> SecureAllocator(const SecureAllocator<U> & other) : _arena(other._arena) {}
+
+        T * allocate(size_t n)
+        {
+            void * memory = _arena->allocate(n * sizeof(T));
+            if( memory == 0 ) throw std::bad_alloc();
+            return (T *) memory;
+        }
+
+        void deallocate(T * memory, size_t n) { _arena->deallocate(memory, n * sizeof(T)); }
+
+        SecureArena & arena() const { return *_arena; }
+
+        template<class U> bool operator==(const SecureAllocator<U> & other) const { return _arena == other._arena; }
+        template<class U> bool operator!=(const SecureAllocator<U> & other) const { return _arena != other._arena; }
+    };
+
+    typedef std::basic_string<char, std::char_traits<char>, SecureAllocator<char>> SecureString;
+    typedef std::vector<unsigned char, SecureAllocator<unsigned char>> SecureBuffer;
+
+};
+
+#endif
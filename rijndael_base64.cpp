@@ -0,0 +1,315 @@
+#include "rijndael.h"
+#include "rijndael_stats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define RIJNDAEL_HAVE_SIMD_BASE64 1
+#endif
+
+namespace Rijndael
+{
+
+    static const char base64Chars[65] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz"
+        "0123456789+/";
+
+    // Character to 6-bit value; 0xFF marks characters outside the alphabet.
+    static const unsigned char base64Values[256] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+        0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+        0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+        0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+
+#ifdef RIJNDAEL_HAVE_SIMD_BASE64
+
+    // The kernels follow Wojciech Mula's and Daniel Lemire's vectorized
+    // base64: bytes are regrouped into 6-bit indices with shuffles and
+    // multiplies, and the alphabet is mapped with pshufb range lookups.
+
+    __attribute__((target("ssse3")))
+    static inline __m128i encodeIndices128(__m128i in)
+    {
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+        const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0);
+        return _mm_add_epi8(_mm_shuffle_epi8(shift, result), indices);
+    }
+
+    // Encodes 12 bytes per step; reads 16 so the loop stops 4 bytes early.
+    __attribute__((target("ssse3")))
+    static size_t encodeSsse3(const unsigned char * in, size_t length, char * out)
+    {
+        size_t done = 0;
+        for(; length - done >= 16; done += 12, out += 16) {
+            _mm_storeu_si128((__m128i *) out, encodeIndices128(_mm_loadu_si128((const __m128i *) (in + done))));
+        }
+        return done;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t encodeAvx2(const unsigned char * in, size_t length, char * out)
+    {
+        size_t done = 0;
+        for(; length - done >= 28; done += 24, out += 32) {
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (in + done))),
+                                                _mm_loadu_si128((const __m128i *) (in + done + 12)), 1);
+            v = _mm256_shuffle_epi8(v, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                       10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+            __m256i t0 = _mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00));
+            __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+            __m256i t2 = _mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0));
+            __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+            __m256i indices = _mm256_or_si256(t1, t3);
+
+            __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+            result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+            const __m256i shift = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                   '/' - 63, 'A', 0, 0,
+                                                   'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                                   '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                                   '/' - 63, 'A', 0, 0);
+            _mm256_storeu_si256((__m256i *) out, _mm256_add_epi8(_mm256_shuffle_epi8(shift, result), indices));
+        }
+        return done;
+    }
+
+    // Decodes 16 characters to 12 bytes per step and stops at the first
+    // character outside the alphabet, leaving it to the scalar loop. The
+    // 16-byte store spills 4 bytes, so a spare 8 characters must follow.
+    __attribute__((target("ssse3")))
+    static size_t decodeSsse3(const char * in, size_t length, unsigned char * out)
+    {
+        const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+        const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        size_t done = 0;
+
+        for(; length - done >= 24; done += 16, out += 12) {
+            __m128i v = _mm_loadu_si128((const __m128i *) (in + done));
+            __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+            __m128i loNibbles = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+            __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+            __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+            if( _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xffff ) break;
+
+            __m128i eq2f = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x2f));
+            __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2f, hiNibbles));
+            v = _mm_add_epi8(v, roll);
+
+            __m128i merged = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+            v = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+            v = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            _mm_storeu_si128((__m128i *) out, v);
+        }
+        return done;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t decodeAvx2(const char * in, size_t length, unsigned char * out)
+    {
+        const __m256i lutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                               0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                               0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                               0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+        const __m256i lutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                               0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                               0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                               0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        size_t done = 0;
+
+        for(; length - done >= 48; done += 32, out += 24) {
+            __m256i v = _mm256_loadu_si256((const __m256i *) (in + done));
+            __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0f));
+            __m256i loNibbles = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+            __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+            __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+            if( !_mm256_testz_si256(lo, hi) ) break;
+
+            __m256i eq2f = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x2f));
+            __m256i roll = _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2f, hiNibbles));
+            v = _mm256_add_epi8(v, roll);
+
+            __m256i merged = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+            v = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+            v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+            _mm256_storeu_si256((__m256i *) out, v);
+        }
+        return done;
+    }
+
+    enum Base64Kernel { KernelScalar, KernelSsse3, KernelAvx2 };
+
+    static Base64Kernel detectKernel()
+    {
+        __builtin_cpu_init();
+        if( __builtin_cpu_supports("avx2") ) return KernelAvx2;
+        if( __builtin_cpu_supports("ssse3") ) return KernelSsse3;
+        return KernelScalar;
+    }
+
+    static size_t encodeSimd(const unsigned char * in, size_t length, char * out)
+    {
+        static const Base64Kernel kernel = detectKernel();
+        if( kernel == KernelAvx2 ) return encodeAvx2(in, length, out);
+        if( kernel == KernelSsse3 ) return encodeSsse3(in, length, out);
+        return 0;
+    }
+
+    static size_t decodeSimd(const char * in, size_t length, unsigned char * out)
+    {
+        static const Base64Kernel kernel = detectKernel();
+        if( kernel == KernelAvx2 ) return decodeAvx2(in, length, out);
+        if( kernel == KernelSsse3 ) return decodeSsse3(in, length, out);
+        return 0;
+    }
+
+#else
+
+    static size_t encodeSimd(const unsigned char *, size_t, char *) { return 0; }
+    static size_t decodeSimd(const char *, size_t, unsigned char *) { return 0; }
+
+#endif
+
+    size_t base64_encoded_size(size_t length)
+    {
+        return (length + 2) / 3 * 4;
+    }
+
+    size_t base64_decoded_size(size_t length)
+    {
+        return length / 4 * 3 + (length % 4) * 3 / 4;
+    }
+
+    size_t base64_encode(const unsigned char * binary, size_t length, char * out)
+    {
+        RIJNDAEL_TIME(Base64Encode);
+        RIJNDAEL_COUNT(Base64Bytes, length);
+
+        size_t done = encodeSimd(binary, length, out);
+        char * o = out + done / 3 * 4;
+
+        for(; length - done >= 3; done += 3) {
+            uint32_t v = ((uint32_t)binary[done] << 16) | ((uint32_t)binary[done + 1] << 8) | binary[done + 2];
+            *o++ = base64Chars[v >> 18];
+            *o++ = base64Chars[(v >> 12) & 0x3f];
+            *o++ = base64Chars[(v >> 6) & 0x3f];
+            *o++ = base64Chars[v & 0x3f];
+        }
+
+        if( length - done == 1 ) {
+            uint32_t v = (uint32_t)binary[done] << 16;
+            *o++ = base64Chars[v >> 18];
+            *o++ = base64Chars[(v >> 12) & 0x3f];
+            *o++ = '=';
+            *o++ = '=';
+        } else if( length - done == 2 ) {
+            uint32_t v = ((uint32_t)binary[done] << 16) | ((uint32_t)binary[done + 1] << 8);
+            *o++ = base64Chars[v >> 18];
+            *o++ = base64Chars[(v >> 12) & 0x3f];
+            *o++ = base64Chars[(v >> 6) & 0x3f];
+            *o++ = '=';
+        }
+
+        return o - out;
+    }
+
+    bool base64_decode(const char * base64, size_t length, unsigned char * out, size_t & written)
+    {
+        RIJNDAEL_TIME(Base64Decode);
+        RIJNDAEL_COUNT(Base64Bytes, length);
+
+        written = 0;
+
+        // Padding is optional but, when present, only at the very end.
+        if( length % 4 == 0 && length > 0 && base64[length - 1] == '=' ) {
+            length--;
+            if( base64[length - 1] == '=' ) length--;
+        }
+        if( length % 4 == 1 ) return false;
+
+        size_t done = decodeSimd(base64, length, out);
+        unsigned char * o = out + done / 4 * 3;
+
+        for(; length - done >= 4; done += 4) {
+            unsigned char a = base64Values[(unsigned char)base64[done]];
+            unsigned char b = base64Values[(unsigned char)base64[done + 1]];
+            unsigned char c = base64Values[(unsigned char)base64[done + 2]];
+            unsigned char d = base64Values[(unsigned char)base64[done + 3]];
+            if( (a | b | c | d) & 0x80 ) return false;
+            uint32_t v = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | d;
+            *o++ = v >> 16;
+            *o++ = v >> 8;
+            *o++ = v;
+        }
+
+        size_t rest = length - done;
+        if( rest > 0 ) {
+            unsigned char a = base64Values[(unsigned char)base64[done]];
+            unsigned char b = base64Values[(unsigned char)base64[done + 1]];
+            unsigned char c = rest == 3 ? base64Values[(unsigned char)base64[done + 2]] : 0;
+            if( (a | b | c) & 0x80 ) return false;
+            uint32_t v = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+            *o++ = v >> 16;
+            if( rest == 3 ) *o++ = v >> 8;
+        }
+
+        written = o - out;
+        return true;
+    }
+
+    std::string base64_encode(unsigned char * binary, unsigned int length)
+    {
+        std::string ret(base64_encoded_size(length), '\0');
+        base64_encode(binary, length, &ret[0]);
+        return ret;
+    }
+
+    // Decodes up to the first character outside the alphabet (padding
+    // included) and NUL-terminates the result. The caller owns the buffer.
+    unsigned char * base64_decode(std::string base64)
+    {
+        size_t length = 0;
+        while( length < base64.size() && base64Values[(unsigned char)base64[length]] != 0xff ) length++;
+        if( length % 4 == 1 ) length--;
+
+        unsigned char * ret = new unsigned char[base64_decoded_size(length) + 1];
+        size_t written;
+        base64_decode(base64.data(), length, ret, written);
+        ret[written] = 0;
+        return ret;
+    }
+
+};
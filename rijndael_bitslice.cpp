@@ -0,0 +1,124 @@
+#include "rijndael_bitslice.h"
+#include "rijndael.h"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RIJNDAEL_HAVE_SSE2 1
+#endif
+
+namespace Rijndael
+{
+namespace Bitslice
+{
+
+#ifdef RIJNDAEL_HAVE_SSE2
+
+    static bool detectAvx2()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+
+    struct Lanes128
+    {
+        static const int lanes = 2;
+        __m128i v;
+
+        static Lanes128 make(__m128i x) { Lanes128 r; r.v = x; return r; }
+        static Lanes128 broadcast(uint64_t x) { return make(_mm_set1_epi64x((long long)x)); }
+        static Lanes128 load(const uint64_t * p) { return make(_mm_load_si128((const __m128i *) p)); }
+        void store(uint64_t * p) const { _mm_store_si128((__m128i *) p, v); }
+        template<int S> Lanes128 shl() const { return make(_mm_slli_epi64(v, S)); }
+        template<int S> Lanes128 shr() const { return make(_mm_srli_epi64(v, S)); }
+        Lanes128 operator^(Lanes128 o) const { return make(_mm_xor_si128(v, o.v)); }
+        Lanes128 operator&(Lanes128 o) const { return make(_mm_and_si128(v, o.v)); }
+        Lanes128 operator|(Lanes128 o) const { return make(_mm_or_si128(v, o.v)); }
+        Lanes128 operator~() const { return make(_mm_xor_si128(v, _mm_set1_epi32(-1))); }
+    };
+
+    typedef Lanes128 NativeLanes;
+
+#else
+
+    static bool detectAvx2() { return false; }
+
+    typedef Lanes64 NativeLanes;
+
+#endif
+
+    static bool hasAvx2()
+    {
+        static const bool avx2 = detectAvx2();
+        return avx2;
+    }
+
+    unsigned int blocksPerPass()
+    {
+        return hasAvx2() ? 16 : 4 * NativeLanes::lanes;
+    }
+
+    void expandKey(const unsigned char roundKeys[][16], int rounds, uint64_t * skey)
+    {
+        for(int r = 0; r <= rounds; r++) {
+            uint64_t q[8];
+            for(int i = 0; i < 4; i++) interleaveIn(q[i], q[i + 4], roundKeys[r]);
+
+            Lanes64 planes[8];
+            for(int i = 0; i < 8; i++) planes[i] = Lanes64::broadcast(q[i]);
+            ortho(planes);
+            for(int i = 0; i < 8; i++) skey[8 * r + i] = planes[i].v;
+        }
+    }
+
+    template<int Rounds, bool Encrypt>
+    static inline void pass(const uint64_t * skey, unsigned char * data, size_t per)
+    {
+        if( per == 16 ) {
+            if( Encrypt ) encryptAvx2<Rounds>(skey, data);
+            else decryptAvx2<Rounds>(skey, data);
+        } else {
+            if( Encrypt ) encryptPass<NativeLanes, Rounds>(skey, data);
+            else decryptPass<NativeLanes, Rounds>(skey, data);
+        }
+    }
+
+    template<int Rounds, bool Encrypt>
+    static void process(const uint64_t * skey, unsigned char * data, size_t blocks)
+    {
+        const size_t per = blocksPerPass();
+
+        for(; blocks >= per; blocks -= per, data += 16 * per) pass<Rounds, Encrypt>(skey, data, per);
+
+        if( blocks == 0 ) return;
+
+        // Pad the tail to a full pass; unused lanes are computed and dropped.
+        alignas(32) unsigned char tail[16 * 16];
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, data, 16 * blocks);
+        pass<Rounds, Encrypt>(skey, tail, per);
+        memcpy(data, tail, 16 * blocks);
+        secure_zero(tail, sizeof(tail));
+    }
+
+    template<int Rounds>
+    void encrypt(const uint64_t * skey, unsigned char * data, size_t blocks)
+    {
+        process<Rounds, true>(skey, data, blocks);
+    }
+
+    template<int Rounds>
+    void decrypt(const uint64_t * skey, unsigned char * data, size_t blocks)
+    {
+        process<Rounds, false>(skey, data, blocks);
+    }
+
+    template void encrypt<10>(const uint64_t *, unsigned char *, size_t);
+    template void encrypt<12>(const uint64_t *, unsigned char *, size_t);
+    template void encrypt<14>(const uint64_t *, unsigned char *, size_t);
+    template void decrypt<10>(const uint64_t *, unsigned char *, size_t);
+    template void decrypt<12>(const uint64_t *, unsigned char *, size_t);
+    template void decrypt<14>(const uint64_t *, unsigned char *, size_t);
+
+};
+};
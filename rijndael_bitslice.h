@@ -0,0 +1,397 @@
+#ifndef RIJNDAEL_BITSLICE_H
+#define RIJNDAEL_BITSLICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace Rijndael
+{
+
+    // Constant-time bitsliced AES. Each 64-bit lane carries one bit plane
+    // of four blocks, so a pass over V::lanes lanes handles 4 * V::lanes
+    // blocks and no table is ever indexed by secret data. Round keys are
+    // expanded once into 8 * (Rounds + 1) bit planes and broadcast to every
+    // lane. Rounds is 10, 12 or 14.
+    namespace Bitslice
+    {
+        unsigned int blocksPerPass();
+        void expandKey(const unsigned char roundKeys[][16], int rounds, uint64_t * skey);
+        template<int Rounds> void encrypt(const uint64_t * skey, unsigned char * data, size_t blocks);
+        template<int Rounds> void decrypt(const uint64_t * skey, unsigned char * data, size_t blocks);
+
+        template<int Rounds> void encryptAvx2(const uint64_t * skey, unsigned char * data);
+        template<int Rounds> void decryptAvx2(const uint64_t * skey, unsigned char * data);
+
+        static inline uint32_t loadLe32(const unsigned char * p)
+        {
+            return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        }
+
+        static inline void storeLe32(unsigned char * p, uint32_t w)
+        {
+            p[0] = w; p[1] = w >> 8; p[2] = w >> 16; p[3] = w >> 24;
+        }
+
+        // Spreads one block over two words so that ortho() can transpose
+        // four blocks into eight bit planes.
+        static inline void interleaveIn(uint64_t & q0, uint64_t & q1, const unsigned char * block)
+        {
+            uint64_t x0 = loadLe32(block), x1 = loadLe32(block + 4), x2 = loadLe32(block + 8), x3 = loadLe32(block + 12);
+            x0 |= (x0 << 16); x1 |= (x1 << 16); x2 |= (x2 << 16); x3 |= (x3 << 16);
+            x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL; x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+            x0 |= (x0 << 8); x1 |= (x1 << 8); x2 |= (x2 << 8); x3 |= (x3 << 8);
+            x0 &= 0x00FF00FF00FF00FFULL; x1 &= 0x00FF00FF00FF00FFULL; x2 &= 0x00FF00FF00FF00FFULL; x3 &= 0x00FF00FF00FF00FFULL;
+            q0 = x0 | (x2 << 8);
+            q1 = x1 | (x3 << 8);
+        }
+
+        static inline void interleaveOut(unsigned char * block, uint64_t q0, uint64_t q1)
+        {
+            uint64_t x0 = q0 & 0x00FF00FF00FF00FFULL, x1 = q1 & 0x00FF00FF00FF00FFULL;
+            uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FFULL, x3 = (q1 >> 8) & 0x00FF00FF00FF00FFULL;
+            x0 |= (x0 >> 8); x1 |= (x1 >> 8); x2 |= (x2 >> 8); x3 |= (x3 >> 8);
+            x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL; x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+            storeLe32(block,      (uint32_t)x0 | (uint32_t)(x0 >> 16));
+            storeLe32(block + 4,  (uint32_t)x1 | (uint32_t)(x1 >> 16));
+            storeLe32(block + 8,  (uint32_t)x2 | (uint32_t)(x2 >> 16));
+            storeLe32(block + 12, (uint32_t)x3 | (uint32_t)(x3 >> 16));
+        }
+
+        template<class V, int S>
+        static inline void swapBits(V & x, V & y, uint64_t cl, uint64_t ch)
+        {
+            V a = x, b = y;
+            x = (a & V::broadcast(cl)) | ((b & V::broadcast(cl)).template shl<S>());
+            y = ((a & V::broadcast(ch)).template shr<S>()) | (b & V::broadcast(ch));
+        }
+
+        template<class V>
+        static inline void ortho(V q[8])
+        {
+            const uint64_t c2l = 0x5555555555555555ULL, c2h = 0xAAAAAAAAAAAAAAAAULL;
+            const uint64_t c4l = 0x3333333333333333ULL, c4h = 0xCCCCCCCCCCCCCCCCULL;
+            const uint64_t c8l = 0x0F0F0F0F0F0F0F0FULL, c8h = 0xF0F0F0F0F0F0F0F0ULL;
+
+            swapBits<V, 1>(q[0], q[1], c2l, c2h); swapBits<V, 1>(q[2], q[3], c2l, c2h);
+            swapBits<V, 1>(q[4], q[5], c2l, c2h); swapBits<V, 1>(q[6], q[7], c2l, c2h);
+            swapBits<V, 2>(q[0], q[2], c4l, c4h); swapBits<V, 2>(q[1], q[3], c4l, c4h);
+            swapBits<V, 2>(q[4], q[6], c4l, c4h); swapBits<V, 2>(q[5], q[7], c4l, c4h);
+            swapBits<V, 4>(q[0], q[4], c8l, c8h); swapBits<V, 4>(q[1], q[5], c8l, c8h);
+            swapBits<V, 4>(q[2], q[6], c8l, c8h); swapBits<V, 4>(q[3], q[7], c8l, c8h);
+        }
+
+        // Boyar-Peralta S-box circuit: 32 AND and 83 XOR/XNOR gates.
+        template<class V>
+        static inline void subBytes(V q[8])
+        {
+            V x0 = q[7], x1 = q[6], x2 = q[5], x3 = q[4], x4 = q[3], x5 = q[2], x6 = q[1], x7 = q[0];
+
+            V y14 = x3 ^ x5;
+            V y13 = x0 ^ x6;
+            V y9  = x0 ^ x3;
+            V y8  = x0 ^ x5;
+            V t0  = x1 ^ x2;
+            V y1  = t0 ^ x7;
+            V y4  = y1 ^ x3;
+            V y12 = y13 ^ y14;
+            V y2  = y1 ^ x0;
+            V y5  = y1 ^ x6;
+            V y3  = y5 ^ y8;
+            V t1  = x4 ^ y12;
+            V y15 = t1 ^ x5;
+            V y20 = t1 ^ x1;
+            V y6  = y15 ^ x7;
+            V y10 = y15 ^ t0;
+            V y11 = y20 ^ y9;
+            V y7  = x7 ^ y11;
+            V y17 = y10 ^ y11;
+            V y19 = y10 ^ y8;
+            V y16 = t0 ^ y11;
+            V y21 = y13 ^ y16;
+            V y18 = x0 ^ y16;
+
+            V t2  = y12 & y15;
+            V t3  = y3 & y6;
+            V t4  = t3 ^ t2;
+            V t5  = y4 & x7;
+            V t6  = t5 ^ t2;
+            V t7  = y13 & y16;
+            V t8  = y5 & y1;
+            V t9  = t8 ^ t7;
+            V t10 = y2 & y7;
+            V t11 = t10 ^ t7;
+            V t12 = y9 & y11;
+            V t13 = y14 & y17;
+            V t14 = t13 ^ t12;
+            V t15 = y8 & y10;
+            V t16 = t15 ^ t12;
+            V t17 = t4 ^ t14;
+            V t18 = t6 ^ t16;
+            V t19 = t9 ^ t14;
+            V t20 = t11 ^ t16;
+            V t21 = t17 ^ y20;
+            V t22 = t18 ^ y19;
+            V t23 = t19 ^ y21;
+            V t24 = t20 ^ y18;
+
+            V t25 = t21 ^ t22;
+            V t26 = t21 & t23;
+            V t27 = t24 ^ t26;
+            V t28 = t25 & t27;
+            V t29 = t28 ^ t22;
+            V t30 = t23 ^ t24;
+            V t31 = t22 ^ t26;
+            V t32 = t31 & t30;
+            V t33 = t32 ^ t24;
+            V t34 = t23 ^ t33;
+            V t35 = t27 ^ t33;
+            V t36 = t24 & t35;
+            V t37 = t36 ^ t34;
+            V t38 = t27 ^ t36;
+            V t39 = t29 & t38;
+            V t40 = t25 ^ t39;
+
+            V t41 = t40 ^ t37;
+            V t42 = t29 ^ t33;
+            V t43 = t29 ^ t40;
+            V t44 = t33 ^ t37;
+            V t45 = t42 ^ t41;
+            V z0  = t44 & y15;
+            V z1  = t37 & y6;
+            V z2  = t33 & x7;
+            V z3  = t43 & y16;
+            V z4  = t40 & y1;
+            V z5  = t29 & y7;
+            V z6  = t42 & y11;
+            V z7  = t45 & y17;
+            V z8  = t41 & y10;
+            V z9  = t44 & y12;
+            V z10 = t37 & y3;
+            V z11 = t33 & y4;
+            V z12 = t43 & y13;
+            V z13 = t40 & y5;
+            V z14 = t29 & y2;
+            V z15 = t42 & y9;
+            V z16 = t45 & y14;
+            V z17 = t41 & y8;
+
+            V t46 = z15 ^ z16;
+            V t47 = z10 ^ z11;
+            V t48 = z5 ^ z13;
+            V t49 = z9 ^ z10;
+            V t50 = z2 ^ z12;
+            V t51 = z2 ^ z5;
+            V t52 = z7 ^ z8;
+            V t53 = z0 ^ z3;
+            V t54 = z6 ^ z7;
+            V t55 = z16 ^ z17;
+            V t56 = z12 ^ t48;
+            V t57 = t50 ^ t53;
+            V t58 = z4 ^ t46;
+            V t59 = z3 ^ t54;
+            V t60 = t46 ^ t57;
+            V t61 = z14 ^ t57;
+            V t62 = t52 ^ t58;
+            V t63 = t49 ^ t58;
+            V t64 = z4 ^ t59;
+            V t65 = t61 ^ t62;
+            V t66 = z1 ^ t63;
+            V s0  = t59 ^ t63;
+            V s6  = t56 ^ ~t62;
+            V s7  = t48 ^ ~t60;
+            V t67 = t64 ^ t65;
+            V s3  = t53 ^ t66;
+            V s4  = t51 ^ t66;
+            V s5  = t47 ^ t65;
+            V s1  = t64 ^ ~s3;
+            V s2  = t55 ^ ~t67;
+
+            q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+            q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+        }
+
+        // The inverse S-box is the forward circuit wrapped in the inverse
+        // affine transform on both sides.
+        template<class V>
+        static inline void inverseAffine(V q[8])
+        {
+            V q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+            q[7] = q1 ^ q4 ^ q6;
+            q[6] = q0 ^ q3 ^ q5;
+            q[5] = q7 ^ q2 ^ q4;
+            q[4] = q6 ^ q1 ^ q3;
+            q[3] = q5 ^ q0 ^ q2;
+            q[2] = q4 ^ q7 ^ q1;
+            q[1] = q3 ^ q6 ^ q0;
+            q[0] = q2 ^ q5 ^ q7;
+        }
+
+        template<class V>
+        static inline void reverseSubBytes(V q[8])
+        {
+            inverseAffine(q);
+            subBytes(q);
+            inverseAffine(q);
+        }
+
+        template<class V>
+        static inline void shiftRows(V q[8])
+        {
+            for(int i = 0; i < 8; i++) {
+                V x = q[i];
+                q[i] = (x & V::broadcast(0x000000000000FFFFULL))
+                     | (x & V::broadcast(0x00000000FFF00000ULL)).template shr<4>()
+                     | (x & V::broadcast(0x00000000000F0000ULL)).template shl<12>()
+                     | (x & V::broadcast(0x0000FF0000000000ULL)).template shr<8>()
+                     | (x & V::broadcast(0x000000FF00000000ULL)).template shl<8>()
+                     | (x & V::broadcast(0xF000000000000000ULL)).template shr<12>()
+                     | (x & V::broadcast(0x0FFF000000000000ULL)).template shl<4>();
+            }
+        }
+
+        template<class V>
+        static inline void reverseShiftRows(V q[8])
+        {
+            for(int i = 0; i < 8; i++) {
+                V x = q[i];
+                q[i] = (x & V::broadcast(0x000000000000FFFFULL))
+                     | (x & V::broadcast(0x000000000FFF0000ULL)).template shl<4>()
+                     | (x & V::broadcast(0x00000000F0000000ULL)).template shr<12>()
+                     | (x & V::broadcast(0x000000FF00000000ULL)).template shl<8>()
+                     | (x & V::broadcast(0x0000FF0000000000ULL)).template shr<8>()
+                     | (x & V::broadcast(0x000F000000000000ULL)).template shl<12>()
+                     | (x & V::broadcast(0xFFF0000000000000ULL)).template shr<4>();
+            }
+        }
+
+        template<class V>
+        static inline V rotr16(V x) { return x.template shr<16>() | x.template shl<48>(); }
+
+        template<class V>
+        static inline V rotr32(V x) { return x.template shr<32>() | x.template shl<32>(); }
+
+        template<class V>
+        static inline void mixColumns(V q[8])
+        {
+            V q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+            V r0 = rotr16(q0), r1 = rotr16(q1), r2 = rotr16(q2), r3 = rotr16(q3);
+            V r4 = rotr16(q4), r5 = rotr16(q5), r6 = rotr16(q6), r7 = rotr16(q7);
+
+            q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+            q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+            q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+            q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+            q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+            q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+            q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+            q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+        }
+
+        template<class V>
+        static inline void reverseMixColumns(V q[8])
+        {
+            V q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+            V r0 = rotr16(q0), r1 = rotr16(q1), r2 = rotr16(q2), r3 = rotr16(q3);
+            V r4 = rotr16(q4), r5 = rotr16(q5), r6 = rotr16(q6), r7 = rotr16(q7);
+
+            q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ rotr32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+            q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+            q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ rotr32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+            q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^ rotr32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+            q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+            q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^ rotr32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+            q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^ rotr32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+            q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^ rotr32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+        }
+
+        template<class V>
+        static inline void addRoundKey(V q[8], const uint64_t * skey)
+        {
+            for(int i = 0; i < 8; i++) q[i] = q[i] ^ V::broadcast(skey[i]);
+        }
+
+        // Transposes 4 * V::lanes blocks into bit planes and back.
+        template<class V>
+        static inline void load(V q[8], const unsigned char * data)
+        {
+            alignas(32) uint64_t planes[8][V::lanes];
+            for(int j = 0; j < V::lanes; j++) {
+                for(int i = 0; i < 4; i++) {
+                    interleaveIn(planes[i][j], planes[i + 4][j], data + 16 * (4 * j + i));
+                }
+            }
+            for(int i = 0; i < 8; i++) q[i] = V::load(planes[i]);
+            ortho(q);
+        }
+
+        template<class V>
+        static inline void store(V q[8], unsigned char * data)
+        {
+            alignas(32) uint64_t planes[8][V::lanes];
+            ortho(q);
+            for(int i = 0; i < 8; i++) q[i].store(planes[i]);
+            for(int j = 0; j < V::lanes; j++) {
+                for(int i = 0; i < 4; i++) {
+                    interleaveOut(data + 16 * (4 * j + i), planes[i][j], planes[i + 4][j]);
+                }
+            }
+        }
+
+        template<class V, int Rounds>
+        static inline void encryptPass(const uint64_t * skey, unsigned char * data)
+        {
+            V q[8];
+            load(q, data);
+            addRoundKey(q, skey);
+            for(int r = 1; r < Rounds; r++) {
+                subBytes(q);
+                shiftRows(q);
+                mixColumns(q);
+                addRoundKey(q, skey + 8 * r);
+            }
+            subBytes(q);
+            shiftRows(q);
+            addRoundKey(q, skey + 8 * Rounds);
+            store(q, data);
+        }
+
+        template<class V, int Rounds>
+        static inline void decryptPass(const uint64_t * skey, unsigned char * data)
+        {
+            V q[8];
+            load(q, data);
+            addRoundKey(q, skey + 8 * Rounds);
+            for(int r = Rounds - 1; r > 0; r--) {
+                reverseShiftRows(q);
+                reverseSubBytes(q);
+                addRoundKey(q, skey + 8 * r);
+                reverseMixColumns(q);
+            }
+            reverseShiftRows(q);
+            reverseSubBytes(q);
+            addRoundKey(q, skey);
+            store(q, data);
+        }
+
+        // Plain 64-bit lanes; also used to expand the key schedule.
+        struct Lanes64
+        {
+            static const int lanes = 1;
+            uint64_t v;
+
+            static Lanes64 broadcast(uint64_t x) { Lanes64 r = { x }; return r; }
+            static Lanes64 load(const uint64_t * p) { Lanes64 r = { p[0] }; return r; }
+            void store(uint64_t * p) const { p[0] = v; }
+            template<int S> Lanes64 shl() const { Lanes64 r = { v << S }; return r; }
+            template<int S> Lanes64 shr() const { Lanes64 r = { v >> S }; return r; }
+            Lanes64 operator^(Lanes64 o) const { Lanes64 r = { v ^ o.v }; return r; }
+            Lanes64 operator&(Lanes64 o) const { Lanes64 r = { v & o.v }; return r; }
+            Lanes64 operator|(Lanes64 o) const { Lanes64 r = { v | o.v }; return r; }
+            Lanes64 operator~() const { Lanes64 r = { ~v }; return r; }
+        };
+
+    };
+
+};
+
+#endif
@@ -0,0 +1,62 @@
+#if defined(__x86_64__) || defined(__i386__)
+#pragma GCC target("avx2")
+#endif
+
+#include "rijndael_bitslice.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace Rijndael
+{
+namespace Bitslice
+{
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    struct Lanes256
+    {
+        static const int lanes = 4;
+        __m256i v;
+
+        static Lanes256 make(__m256i x) { Lanes256 r; r.v = x; return r; }
+        static Lanes256 broadcast(uint64_t x) { return make(_mm256_set1_epi64x((long long)x)); }
+        static Lanes256 load(const uint64_t * p) { return make(_mm256_load_si256((const __m256i *) p)); }
+        void store(uint64_t * p) const { _mm256_store_si256((__m256i *) p, v); }
+        template<int S> Lanes256 shl() const { return make(_mm256_slli_epi64(v, S)); }
+        template<int S> Lanes256 shr() const { return make(_mm256_srli_epi64(v, S)); }
+        Lanes256 operator^(Lanes256 o) const { return make(_mm256_xor_si256(v, o.v)); }
+        Lanes256 operator&(Lanes256 o) const { return make(_mm256_and_si256(v, o.v)); }
+        Lanes256 operator|(Lanes256 o) const { return make(_mm256_or_si256(v, o.v)); }
+        Lanes256 operator~() const { return make(_mm256_xor_si256(v, _mm256_set1_epi32(-1))); }
+    };
+
+    template<int Rounds>
+    void encryptAvx2(const uint64_t * skey, unsigned char * data)
+    {
+        encryptPass<Lanes256, Rounds>(skey, data);
+    }
+
+    template<int Rounds>
+    void decryptAvx2(const uint64_t * skey, unsigned char * data)
+    {
+        decryptPass<Lanes256, Rounds>(skey, data);
+    }
+
+#else
+
+    template<int Rounds> void encryptAvx2(const uint64_t *, unsigned char *) {}
+    template<int Rounds> void decryptAvx2(const uint64_t *, unsigned char *) {}
+
+#endif
+
+    template void encryptAvx2<10>(const uint64_t *, unsigned char *);
+    template void encryptAvx2<12>(const uint64_t *, unsigned char *);
+    template void encryptAvx2<14>(const uint64_t *, unsigned char *);
+    template void decryptAvx2<10>(const uint64_t *, unsigned char *);
+    template void decryptAvx2<12>(const uint64_t *, unsigned char *);
+    template void decryptAvx2<14>(const uint64_t *, unsigned char *);
+
+};
+};
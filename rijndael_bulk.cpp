@@ -0,0 +1,83 @@
+#include "rijndael_bulk.h"
+#include "rijndael_ctr.h"
+#include "rijndael_stats.h"
+
+namespace Rijndael
+{
+
+    void Bulk::encryptEcb(const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        RIJNDAEL_TIME(BulkEcb);
+        RIJNDAEL_COUNT(BulkBytes, 16 * nblocks);
+
+        if( !_parallel(16 * nblocks) ) {
+            _cipher.encryptBlocks(in, out, nblocks);
+            return;
+        }
+
+        _pool->runChunks(16 * nblocks, _chunk, [&](size_t offset, size_t length) {
+            _cipher.encryptBlocks(in + offset, out + offset, length / 16);
+        });
+    }
+
+    void Bulk::decryptEcb(const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        RIJNDAEL_TIME(BulkEcb);
+        RIJNDAEL_COUNT(BulkBytes, 16 * nblocks);
+
+        if( !_parallel(16 * nblocks) ) {
+            _cipher.decryptBlocks(in, out, nblocks);
+            return;
+        }
+
+        _pool->runChunks(16 * nblocks, _chunk, [&](size_t offset, size_t length) {
+            _cipher.decryptBlocks(in + offset, out + offset, length / 16);
+        });
+    }
+
+    void Bulk::ctr(const uint8_t counter[16], uint64_t offset, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        RIJNDAEL_TIME(BulkCtr);
+        RIJNDAEL_COUNT(BulkBytes, length);
+
+        Ctr mode(_cipher, counter);
+        mode.setThreadPool(_pool);
+        mode.setParallelThreshold(_threshold);
+        mode.setChunkSize(_chunk);
+        mode.processAt(offset, in, out, length);
+    }
+
+    bool Bulk::_xts(bool encrypting, const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        if( sectorSize < 16 || (length % sectorSize != 0 && length % sectorSize < 16) ) return false;
+
+        RIJNDAEL_TIME(BulkXts);
+        RIJNDAEL_COUNT(BulkBytes, length);
+
+        size_t sectors = _chunk / sectorSize;
+        size_t chunk = sectorSize * (sectors == 0 ? 1 : sectors);
+        auto task = [&](size_t offset, size_t n) {
+            for(size_t done = 0; done < n; done += sectorSize) {
+                size_t size = n - done < sectorSize ? n - done : sectorSize;
+                uint64_t number = sector + (offset + done) / sectorSize;
+                if( encrypting ) xts.encryptSector(number, in + offset + done, out + offset + done, size);
+                else xts.decryptSector(number, in + offset + done, out + offset + done, size);
+            }
+        };
+
+        if( _parallel(length) ) _pool->runChunks(length, chunk, task);
+        else task(0, length);
+        return true;
+    }
+
+    bool Bulk::encryptXts(const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        return _xts(true, xts, sector, sectorSize, in, out, length);
+    }
+
+    bool Bulk::decryptXts(const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        return _xts(false, xts, sector, sectorSize, in, out, length);
+    }
+
+};
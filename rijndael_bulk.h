@@ -0,0 +1,53 @@
+#ifndef RIJNDAEL_BULK_H
+#define RIJNDAEL_BULK_H
+
+#include "rijndael.h"
+#include "rijndael_threadpool.h"
+#include "rijndael_xts.h"
+
+namespace Rijndael
+{
+
+    // Multi-threaded bulk ECB, CTR and XTS for large buffers. Inputs of at least
+    // parallelThreshold() bytes are cut into chunkSize() pieces and spread
+    // over the attached ThreadPool, whose size sets the thread count;
+    // anything smaller, or with no pool, runs on the calling thread. Every
+    // chunk is an independent slice of the sequential computation, so the
+    // output is byte-identical to the single-threaded path.
+    class Bulk
+    {
+    protected:
+        const BlockCipher & _cipher;
+        ThreadPool * _pool;
+        size_t _threshold;
+        size_t _chunk;
+
+        bool _parallel(size_t length) const { return _pool != 0 && _pool->size() > 1 && length >= _threshold; }
+        bool _xts(bool encrypting, const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const;
+
+    public:
+        Bulk(const BlockCipher & cipher, ThreadPool * pool = 0) : _cipher(cipher), _pool(pool), _threshold(256 * 1024), _chunk(64 * 1024) {}
+
+        void setThreadPool(ThreadPool * pool) { _pool = pool; }
+        void setParallelThreshold(size_t bytes) { _threshold = bytes; }
+        void setChunkSize(size_t bytes) { _chunk = bytes < 16 ? 16 : bytes & ~(size_t)15; }
+        size_t parallelThreshold() const { return _threshold; }
+        size_t chunkSize() const { return _chunk; }
+
+        void encryptEcb(const uint8_t * in, uint8_t * out, size_t nblocks) const;
+        void decryptEcb(const uint8_t * in, uint8_t * out, size_t nblocks) const;
+
+        // CTR keystream starting at byte offset of the stream for counter;
+        // see Ctr.
+        void ctr(const uint8_t counter[16], uint64_t offset, const uint8_t * in, uint8_t * out, size_t length) const;
+
+        // XTS over consecutive sectors of sectorSize bytes numbered from
+        // sector. Chunks are rounded to whole sectors; only the last sector
+        // may be short, and it must still hold at least one block.
+        bool encryptXts(const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const;
+        bool decryptXts(const Xts & xts, uint64_t sector, size_t sectorSize, const uint8_t * in, uint8_t * out, size_t length) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "rijndael_cbc.h"
+#include "rijndael_stream.h"
+
+namespace Rijndael
+{
+
+    static const size_t cbcBatchBlocks = 32;
+
+    static inline void xorBlock(uint8_t * out, const unsigned char * a, const unsigned char * b)
+    {
+        for(int i = 0; i < 16; i += 8) {
+            uint64_t x, y;
+            memcpy(&x, a + i, 8);
+            memcpy(&y, b + i, 8);
+            x ^= y;
+            memcpy(out + i, &x, 8);
+        }
+    }
+
+    void Cbc::encryptBlocks(uint8_t iv[16], const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        unsigned char block[16];
+
+        for(; nblocks > 0; nblocks--, in += 16, out += 16) {
+            xorBlock(block, in, iv);
+            _cipher.encryptBlocks(block, out, 1);
+            memcpy(iv, out, 16);
+        }
+
+        secure_zero(block, sizeof(block));
+    }
+
+    void Cbc::decryptBlocks(uint8_t iv[16], const uint8_t * in, uint8_t * out, size_t nblocks) const
+    {
+        unsigned char buffer[cbcBatchBlocks * 16];
+        unsigned char previous[16];
+
+        while( nblocks > 0 ) {
+            size_t n = nblocks < cbcBatchBlocks ? nblocks : cbcBatchBlocks;
+
+            // Keep this batch's last ciphertext block for the next one before
+            // an in-place caller overwrites it.
+            memcpy(previous, in + 16 * (n - 1), 16);
+            _cipher.decryptBlocks(in, buffer, n);
+
+            // Back to front, so with in == out every ciphertext block is still
+            // intact when the block after it needs it.
+            for(size_t i = n - 1; i > 0; i--) xorBlock(out + 16 * i, buffer + 16 * i, in + 16 * (i - 1));
+            xorBlock(out, buffer, iv);
+            memcpy(iv, previous, 16);
+
+            in += 16 * n;
+            out += 16 * n;
+            nblocks -= n;
+        }
+
+        secure_zero(buffer, sizeof(buffer));
+    }
+
+    size_t Cbc::encrypt(const uint8_t iv[16], const uint8_t * in, size_t length, uint8_t * out) const
+    {
+        unsigned char chain[16], last[16];
+        size_t blocks = length / 16;
+        size_t tail = length % 16;
+
+        memcpy(chain, iv, 16);
+        encryptBlocks(chain, in, out, blocks);
+
+        memcpy(last, in + 16 * blocks, tail);
+        memset(last + tail, 16 - tail, 16 - tail);
+        encryptBlocks(chain, last, out + 16 * blocks, 1);
+
+        secure_zero(last, sizeof(last));
+        return 16 * blocks + 16;
+    }
+
+    bool Cbc::decrypt(const uint8_t iv[16], const uint8_t * in, size_t length, uint8_t * out, size_t & written) const
+    {
+        unsigned char chain[16];
+        size_t lastLength;
+
+        written = 0;
+        if( length == 0 || length % 16 != 0 ) {
+            memset(out, 0, length);
+            return false;
+        }
+
+        memcpy(chain, iv, 16);
+        decryptBlocks(chain, in, out, length / 16);
+
+        if( !pkcs7_unpad(out + length - 16, lastLength) ) {
+            memset(out, 0, length);
+            return false;
+        }
+
+        written = length - 16 + lastLength;
+        return true;
+    }
+
+};
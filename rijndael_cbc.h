@@ -0,0 +1,39 @@
+#ifndef RIJNDAEL_CBC_H
+#define RIJNDAEL_CBC_H
+
+#include "rijndael.h"
+
+namespace Rijndael
+{
+
+    // AES-CBC (NIST SP 800-38A). Encryption feeds each ciphertext block into
+    // the next and is inherently serial. Decryption is not: batches of
+    // ciphertext blocks go through decryptBlocks together, so the engine's
+    // interleaved paths (8 blocks on AES-NI, 4 on TTable, 8 or 16 bitsliced)
+    // keep several blocks in flight, and only the final XOR is chained.
+    class Cbc
+    {
+    protected:
+        const BlockCipher & _cipher;
+
+    public:
+        Cbc(const BlockCipher & cipher) : _cipher(cipher) {}
+
+        // Whole blocks, no padding. iv is replaced by the last ciphertext
+        // block, so consecutive calls continue one message. in and out may
+        // be the same buffer.
+        void encryptBlocks(uint8_t iv[16], const uint8_t * in, uint8_t * out, size_t nblocks) const;
+        void decryptBlocks(uint8_t iv[16], const uint8_t * in, uint8_t * out, size_t nblocks) const;
+
+        // One-shot messages with PKCS#7 padding. encrypt writes
+        // paddedSize(length) bytes. decrypt needs length bytes of room and
+        // returns false, with out zeroed, if length is not a positive
+        // multiple of 16 or the padding is malformed.
+        static size_t paddedSize(size_t length) { return length / 16 * 16 + 16; }
+        size_t encrypt(const uint8_t iv[16], const uint8_t * in, size_t length, uint8_t * out) const;
+        bool decrypt(const uint8_t iv[16], const uint8_t * in, size_t length, uint8_t * out, size_t & written) const;
+    };
+
+};
+
+#endif
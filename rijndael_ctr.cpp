@@ -0,0 +1,89 @@
+#include "rijndael_ctr.h"
+
+namespace Rijndael
+{
+
+    static const size_t ctrBatchBlocks = 64;
+
+    Ctr::Ctr(const BlockCipher & cipher, const uint8_t counter[16]) : _cipher(cipher), _offset(0), _pool(0), _threshold(256 * 1024), _chunk(64 * 1024)
+    {
+        memcpy(_counter, counter, 16);
+    }
+
+    // Writes the counter block for block index into out.
+    static inline void counterBlock(const unsigned char base[16], uint64_t index, unsigned char out[16])
+    {
+        unsigned int carry = 0;
+        for(int i = 15; i >= 0; i--) {
+            unsigned int sum = base[i] + (unsigned int)(index & 0xff) + carry;
+            out[i] = sum;
+            carry = sum >> 8;
+            index >>= 8;
+        }
+    }
+
+    void Ctr::_crypt(uint64_t offset, const uint8_t * in, uint8_t * out, size_t length)
+    {
+        unsigned char keystream[ctrBatchBlocks * 16];
+        uint64_t block = offset / 16;
+        size_t skip = offset % 16;
+
+        while( length > 0 ) {
+            size_t blocks = (skip + length + 15) / 16;
+            if( blocks > ctrBatchBlocks ) blocks = ctrBatchBlocks;
+
+            counterBlock(_counter, block, keystream);
+            for(size_t i = 1; i < blocks; i++) {
+                unsigned char * c = keystream + 16 * i;
+                memcpy(c, c - 16, 16);
+                for(int j = 15; j >= 0 && ++c[j] == 0; j--);
+            }
+            _cipher.encryptBlocks(keystream, keystream, blocks);
+
+            size_t n = blocks * 16 - skip;
+            if( n > length ) n = length;
+            size_t i = 0;
+            for(; i + 8 <= n; i += 8) {
+                uint64_t a, k;
+                memcpy(&a, in + i, 8);
+                memcpy(&k, keystream + skip + i, 8);
+                a ^= k;
+                memcpy(out + i, &a, 8);
+            }
+            for(; i < n; i++) out[i] = in[i] ^ keystream[skip + i];
+
+            in += n;
+            out += n;
+            length -= n;
+            block += blocks;
+            skip = 0;
+        }
+
+        secure_zero(keystream, sizeof(keystream));
+    }
+
+    void Ctr::processAt(uint64_t offset, const uint8_t * in, uint8_t * out, size_t length)
+    {
+        if( _pool == 0 || _pool->size() < 2 || length < _threshold ) {
+            _crypt(offset, in, out, length);
+            return;
+        }
+
+        // Cut at block boundaries of the keystream so chunks never share a
+        // counter block.
+        size_t head = (16 - offset % 16) % 16;
+        if( head > length ) head = length;
+
+        _crypt(offset, in, out, head);
+        _pool->runChunks(length - head, _chunk, [&](size_t start, size_t n) {
+            _crypt(offset + head + start, in + head + start, out + head + start, n);
+        });
+    }
+
+    void Ctr::process(const uint8_t * in, uint8_t * out, size_t length)
+    {
+        processAt(_offset, in, out, length);
+        _offset += length;
+    }
+
+};
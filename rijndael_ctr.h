@@ -0,0 +1,52 @@
+#ifndef RIJNDAEL_CTR_H
+#define RIJNDAEL_CTR_H
+
+#include "rijndael.h"
+#include "rijndael_threadpool.h"
+
+namespace Rijndael
+{
+
+    // AES-CTR (NIST SP 800-38A) on top of BlockCipher::encryptBlocks. The counter
+    // block is the caller's 16-byte nonce/counter incremented as a 128-bit
+    // big-endian integer per block, so any byte offset can be reached
+    // directly. Encryption and decryption are the same operation.
+    //
+    // With a ThreadPool attached, inputs of at least parallelThreshold()
+    // bytes are split into block-aligned chunks whose keystreams are
+    // generated independently on the pool's threads.
+    class Ctr
+    {
+    protected:
+        const BlockCipher & _cipher;
+        unsigned char _counter[16];
+        uint64_t _offset;
+        ThreadPool * _pool;
+        size_t _threshold;
+        size_t _chunk;
+
+        void _crypt(uint64_t offset, const uint8_t * in, uint8_t * out, size_t length);
+
+    public:
+        Ctr(const BlockCipher & cipher, const uint8_t counter[16]);
+
+        void setThreadPool(ThreadPool * pool) { _pool = pool; }
+        void setParallelThreshold(size_t bytes) { _threshold = bytes; }
+        void setChunkSize(size_t bytes) { _chunk = bytes < 16 ? 16 : bytes & ~(size_t)15; }
+        size_t parallelThreshold() const { return _threshold; }
+
+        // Stream position in bytes from the start of the keystream.
+        void seek(uint64_t offset) { _offset = offset; }
+        uint64_t tell() const { return _offset; }
+
+        // XORs the keystream at the current position into in and advances.
+        void process(const uint8_t * in, uint8_t * out, size_t length);
+
+        // Random access: XORs the keystream starting at byte offset without
+        // touching the stream position.
+        void processAt(uint64_t offset, const uint8_t * in, uint8_t * out, size_t length);
+    };
+
+};
+
+#endif
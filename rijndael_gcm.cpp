@@ -0,0 +1,369 @@
+#include "rijndael_gcm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define RIJNDAEL_HAVE_CLMUL 1
+#endif
+
+namespace Rijndael
+{
+
+    static inline uint64_t loadBe64(const unsigned char * p)
+    {
+        uint64_t v = 0;
+        for(int i = 0; i < 8; i++) v = (v << 8) | p[i];
+        return v;
+    }
+
+    static inline void storeBe64(unsigned char * p, uint64_t v)
+    {
+        for(int i = 7; i >= 0; i--, v >>= 8) p[i] = v;
+    }
+
+    // Reduction constants for shifting four bits out of the low end.
+    static const uint64_t last4[16] = {
+        0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+        0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+    };
+
+    // state = state * H using the precomputed multiples of H for each nibble.
+    static void gmulTable(const uint64_t hh[16], const uint64_t hl[16], unsigned char state[16])
+    {
+        unsigned char lo = state[15] & 0xf;
+        uint64_t zh = hh[lo];
+        uint64_t zl = hl[lo];
+
+        for(int i = 15; i >= 0; i--) {
+            lo = state[i] & 0xf;
+            unsigned char hi = state[i] >> 4;
+
+            if( i != 15 ) {
+                unsigned char rem = zl & 0xf;
+                zl = (zh << 60) | (zl >> 4);
+                zh = (zh >> 4) ^ (last4[rem] << 48) ^ hh[lo];
+                zl ^= hl[lo];
+            }
+
+            unsigned char rem = zl & 0xf;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4) ^ (last4[rem] << 48) ^ hh[hi];
+            zl ^= hl[hi];
+        }
+
+        storeBe64(state, zh);
+        storeBe64(state + 8, zl);
+    }
+
+#ifdef RIJNDAEL_HAVE_CLMUL
+
+    static bool detectClmul()
+    {
+        unsigned int eax, ebx, ecx, edx;
+        if( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) ) return false;
+        return (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+    }
+
+    // Carry-less multiply and reduce in the byte-reflected domain
+    // (Intel white paper "Carry-Less Multiplication and Its Usage for
+    // Computing the GCM Mode", algorithm 5).
+    __attribute__((target("pclmul,ssse3")))
+    static inline __m128i gfmul(__m128i a, __m128i b)
+    {
+        __m128i t3 = _mm_clmulepi64_si128(a, b, 0x00);
+        __m128i t4 = _mm_clmulepi64_si128(a, b, 0x10);
+        __m128i t5 = _mm_clmulepi64_si128(a, b, 0x01);
+        __m128i t6 = _mm_clmulepi64_si128(a, b, 0x11);
+
+        t4 = _mm_xor_si128(t4, t5);
+        t5 = _mm_slli_si128(t4, 8);
+        t4 = _mm_srli_si128(t4, 8);
+        t3 = _mm_xor_si128(t3, t5);
+        t6 = _mm_xor_si128(t6, t4);
+
+        // Shift the 256-bit product left by one to undo the reflection.
+        __m128i t7 = _mm_srli_epi32(t3, 31);
+        __m128i t8 = _mm_srli_epi32(t6, 31);
+        t3 = _mm_slli_epi32(t3, 1);
+        t6 = _mm_slli_epi32(t6, 1);
+        __m128i t9 = _mm_srli_si128(t7, 12);
+        t8 = _mm_slli_si128(t8, 4);
+        t7 = _mm_slli_si128(t7, 4);
+        t3 = _mm_or_si128(t3, t7);
+        t6 = _mm_or_si128(t6, t8);
+        t6 = _mm_or_si128(t6, t9);
+
+        // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+        t7 = _mm_slli_epi32(t3, 31);
+        t8 = _mm_slli_epi32(t3, 30);
+        t9 = _mm_slli_epi32(t3, 25);
+        t7 = _mm_xor_si128(t7, t8);
+        t7 = _mm_xor_si128(t7, t9);
+        t8 = _mm_srli_si128(t7, 4);
+        t7 = _mm_slli_si128(t7, 12);
+        t3 = _mm_xor_si128(t3, t7);
+
+        __m128i t2 = _mm_srli_epi32(t3, 1);
+        t4 = _mm_srli_epi32(t3, 2);
+        t5 = _mm_srli_epi32(t3, 7);
+        t2 = _mm_xor_si128(t2, t4);
+        t2 = _mm_xor_si128(t2, t5);
+        t2 = _mm_xor_si128(t2, t8);
+        t3 = _mm_xor_si128(t3, t2);
+
+        return _mm_xor_si128(t6, t3);
+    }
+
+    __attribute__((target("pclmul,ssse3")))
+    static void clmulPowers(const unsigned char h[16], unsigned char powers[4][16])
+    {
+        const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m128i h1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) h), swap);
+        __m128i hn = h1;
+
+        for(int i = 0; i < 4; i++) {
+            _mm_store_si128((__m128i *) powers[i], hn);
+            hn = gfmul(hn, h1);
+        }
+    }
+
+    // Four blocks are folded per step as X1*H^4 + X2*H^3 + X3*H^2 + X4*H,
+    // which keeps four independent multiplies in flight.
+    __attribute__((target("pclmul,ssse3")))
+    static void ghashClmul(const unsigned char powers[4][16], unsigned char state[16], const uint8_t * data, size_t blocks)
+    {
+        const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i * hp = (const __m128i *) powers;
+        __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) state), swap);
+
+        for(; blocks >= 4; blocks -= 4, data += 64) {
+            __m128i d0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), swap);
+            __m128i d1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 16)), swap);
+            __m128i d2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 32)), swap);
+            __m128i d3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + 48)), swap);
+            x = _mm_xor_si128(
+                    _mm_xor_si128(gfmul(_mm_xor_si128(x, d0), hp[3]), gfmul(d1, hp[2])),
+                    _mm_xor_si128(gfmul(d2, hp[1]), gfmul(d3, hp[0])));
+        }
+
+        for(; blocks > 0; blocks--, data += 16) {
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), swap);
+            x = gfmul(_mm_xor_si128(x, d), hp[0]);
+        }
+
+        _mm_storeu_si128((__m128i *) state, _mm_shuffle_epi8(x, swap));
+    }
+
+#else
+
+    static bool detectClmul() { return false; }
+    static void clmulPowers(const unsigned char *, unsigned char (*)[16]) {}
+    static void ghashClmul(const unsigned char (*)[16], unsigned char *, const uint8_t *, size_t) {}
+
+#endif
+
+    static bool hasClmul()
+    {
+        static const bool clmul = detectClmul();
+        return clmul;
+    }
+
+    Gcm::Gcm(const BlockCipher & cipher) : _cipher(cipher), _clmul(hasClmul())
+    {
+        unsigned char h[16] = { 0 };
+        _cipher.encryptBlocks(h, h, 1);
+
+        if( _clmul ) {
+            clmulPowers(h, _hPowers);
+            secure_zero(h, sizeof(h));
+            return;
+        }
+
+        // Shoup's 4-bit tables: entry n holds n * H, built from H, H/x,
+        // H/x^2 and H/x^3 by linearity.
+        uint64_t vh = loadBe64(h);
+        uint64_t vl = loadBe64(h + 8);
+        _hh[0] = 0; _hl[0] = 0;
+        _hh[8] = vh; _hl[8] = vl;
+
+        for(int i = 4; i > 0; i >>= 1) {
+            uint64_t t = (vl & 1) * 0xe1000000ULL;
+            vl = (vh << 63) | (vl >> 1);
+            vh = (vh >> 1) ^ (t << 32);
+            _hh[i] = vh; _hl[i] = vl;
+        }
+
+        for(int i = 2; i <= 8; i *= 2) {
+            for(int j = 1; j < i; j++) {
+                _hh[i + j] = _hh[i] ^ _hh[j];
+                _hl[i + j] = _hl[i] ^ _hl[j];
+            }
+        }
+
+        secure_zero(h, sizeof(h));
+    }
+
+    Gcm::~Gcm()
+    {
+        secure_zero(_hh, sizeof(_hh));
+        secure_zero(_hl, sizeof(_hl));
+        secure_zero(_hPowers, sizeof(_hPowers));
+    }
+
+    // Absorbs data into the GHASH state; a trailing partial block is padded
+    // with zeros.
+    void Gcm::_ghash(unsigned char state[16], const uint8_t * data, size_t length) const
+    {
+        size_t blocks = length / 16;
+        size_t rest = length % 16;
+
+        if( _clmul ) {
+            ghashClmul(_hPowers, state, data, blocks);
+        } else {
+            for(size_t b = 0; b < blocks; b++) {
+                for(int i = 0; i < 16; i++) state[i] ^= data[16 * b + i];
+                gmulTable(_hh, _hl, state);
+            }
+        }
+
+        if( rest ) {
+            unsigned char last[16] = { 0 };
+            memcpy(last, data + 16 * blocks, rest);
+            if( _clmul ) {
+                ghashClmul(_hPowers, state, last, 1);
+            } else {
+                for(int i = 0; i < 16; i++) state[i] ^= last[i];
+                gmulTable(_hh, _hl, state);
+            }
+        }
+    }
+
+    void Gcm::_preCounter(const uint8_t * iv, size_t ivLength, unsigned char j0[16]) const
+    {
+        if( ivLength == 12 ) {
+            memcpy(j0, iv, 12);
+            j0[12] = 0; j0[13] = 0; j0[14] = 0; j0[15] = 1;
+            return;
+        }
+
+        unsigned char lengths[16] = { 0 };
+        storeBe64(lengths + 8, (uint64_t)ivLength * 8);
+        secure_zero(j0, 16);
+        _ghash(j0, iv, ivLength);
+        _ghash(j0, lengths, 16);
+    }
+
+    // CTR with a 32-bit counter, hashing each chunk of ciphertext as soon as
+    // it is produced (or, when decrypting, just before it is consumed).
+    void Gcm::_crypt(const unsigned char j0[16], const uint8_t * in, uint8_t * out, size_t length, unsigned char state[16], bool encrypting) const
+    {
+        unsigned char keystream[8 * 16];
+        uint32_t counter = ((uint32_t)j0[12] << 24) | ((uint32_t)j0[13] << 16) | ((uint32_t)j0[14] << 8) | j0[15];
+
+        while( length > 0 ) {
+            size_t n = length < sizeof(keystream) ? length : sizeof(keystream);
+            size_t blocks = (n + 15) / 16;
+
+            for(size_t b = 0; b < blocks; b++) {
+                unsigned char * c = keystream + 16 * b;
+                counter++;
+                memcpy(c, j0, 12);
+                c[12] = counter >> 24; c[13] = counter >> 16; c[14] = counter >> 8; c[15] = counter;
+            }
+            _cipher.encryptBlocks(keystream, keystream, blocks);
+
+            if( !encrypting ) _ghash(state, in, n);
+            for(size_t i = 0; i < n; i++) out[i] = in[i] ^ keystream[i];
+            if( encrypting ) _ghash(state, out, n);
+
+            in += n;
+            out += n;
+            length -= n;
+        }
+
+        secure_zero(keystream, sizeof(keystream));
+    }
+
+    void Gcm::_tag(const unsigned char j0[16], unsigned char state[16], size_t aadLength, size_t length, uint8_t tag[16]) const
+    {
+        unsigned char lengths[16];
+        storeBe64(lengths, (uint64_t)aadLength * 8);
+        storeBe64(lengths + 8, (uint64_t)length * 8);
+        _ghash(state, lengths, 16);
+
+        unsigned char mask[16];
+        _cipher.encryptBlocks(j0, mask, 1);
+        for(int i = 0; i < 16; i++) tag[i] = state[i] ^ mask[i];
+        secure_zero(mask, sizeof(mask));
+    }
+
+    // Compares in the same time wherever the tags differ.
+    static bool sameTag(const unsigned char a[16], const unsigned char b[16])
+    {
+        unsigned char diff = 0;
+        for(int i = 0; i < 16; i++) diff |= a[i] ^ b[i];
+        return diff == 0;
+    }
+
+    bool Gcm::_fits(size_t aadLength, size_t length)
+    {
+        return (uint64_t) length <= maxLength && (uint64_t) aadLength <= maxAadLength;
+    }
+
+    bool Gcm::encrypt(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                      const uint8_t * plaintext, uint8_t * ciphertext, size_t length, uint8_t tag[16]) const
+    {
+        if( !_fits(aadLength, length) ) return false;
+
+        unsigned char j0[16];
+        unsigned char state[16] = { 0 };
+
+        _preCounter(iv, ivLength, j0);
+        _ghash(state, aad, aadLength);
+        _crypt(j0, plaintext, ciphertext, length, state, true);
+        _tag(j0, state, aadLength, length, tag);
+        return true;
+    }
+
+    bool Gcm::decrypt(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                      const uint8_t * ciphertext, uint8_t * plaintext, size_t length, const uint8_t tag[16]) const
+    {
+        if( !_fits(aadLength, length) ) return false;
+
+        unsigned char j0[16];
+        unsigned char state[16] = { 0 };
+        unsigned char expected[16];
+
+        _preCounter(iv, ivLength, j0);
+        _ghash(state, aad, aadLength);
+        _crypt(j0, ciphertext, plaintext, length, state, false);
+        _tag(j0, state, aadLength, length, expected);
+
+        if( !sameTag(expected, tag) ) {
+            memset(plaintext, 0, length);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Gcm::verify(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                     const uint8_t * ciphertext, size_t length, const uint8_t tag[16]) const
+    {
+        if( !_fits(aadLength, length) ) return false;
+
+        unsigned char j0[16];
+        unsigned char state[16] = { 0 };
+        unsigned char expected[16];
+
+        _preCounter(iv, ivLength, j0);
+        _ghash(state, aad, aadLength);
+        _ghash(state, ciphertext, length);
+        _tag(j0, state, aadLength, length, expected);
+
+        return sameTag(expected, tag);
+    }
+
+};
@@ -0,0 +1,56 @@
+#ifndef RIJNDAEL_GCM_H
+#define RIJNDAEL_GCM_H
+
+#include "rijndael.h"
+
+namespace Rijndael
+{
+
+    // AES-GCM (NIST SP 800-38D) with a 128-bit tag. GHASH runs on PCLMULQDQ
+    // when the CPU has it and on 4-bit Shoup tables otherwise. Each chunk of
+    // data is encrypted and hashed while it is still in cache, so the buffer
+    // is only streamed through memory once.
+    class Gcm
+    {
+    protected:
+        const BlockCipher & _cipher;
+        uint64_t _hh[16];
+        uint64_t _hl[16];
+        alignas(16) unsigned char _hPowers[4][16];
+        bool _clmul;
+
+        void _ghash(unsigned char state[16], const uint8_t * data, size_t length) const;
+        void _preCounter(const uint8_t * iv, size_t ivLength, unsigned char j0[16]) const;
+        void _crypt(const unsigned char j0[16], const uint8_t * in, uint8_t * out, size_t length, unsigned char state[16], bool encrypting) const;
+        void _tag(const unsigned char j0[16], unsigned char state[16], size_t aadLength, size_t length, uint8_t tag[16]) const;
+        static bool _fits(size_t aadLength, size_t length);
+
+    public:
+        // SP 800-38D limits: the 32-bit block counter covers 2^32 - 2 blocks
+        // of text, and the AAD length must fit in 64 bits of bit count.
+        static const uint64_t maxLength = ((uint64_t)1 << 36) - 32;
+        static const uint64_t maxAadLength = ((uint64_t)1 << 61) - 1;
+
+        Gcm(const BlockCipher & cipher);
+        ~Gcm();
+
+        // Returns false and writes nothing if length exceeds maxLength or
+        // aadLength exceeds maxAadLength; the keystream would repeat.
+        bool encrypt(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                     const uint8_t * plaintext, uint8_t * ciphertext, size_t length, uint8_t tag[16]) const;
+
+        // Returns false and zeroes plaintext if the tag does not match. The
+        // comparison takes the same time wherever the tags differ. Oversized
+        // input is rejected as in encrypt(), without touching plaintext.
+        bool decrypt(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                     const uint8_t * ciphertext, uint8_t * plaintext, size_t length, const uint8_t tag[16]) const;
+
+        // Checks the tag without decrypting, so a caller can reject forged
+        // data before any plaintext exists.
+        bool verify(const uint8_t * iv, size_t ivLength, const uint8_t * aad, size_t aadLength,
+                    const uint8_t * ciphertext, size_t length, const uint8_t tag[16]) const;
+    };
+
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef RIJNDAEL_INTERNAL_H
+#define RIJNDAEL_INTERNAL_H
+
+namespace Rijndael
+{
+
+    // Converts a 16-byte chunk between the string API's row-by-row layout
+    // and FIPS-197 byte order, in either direction. Lets the string API
+    // implementations (Cipher, EncryptQueue) batch chunks through
+    // encryptBlocks() with identical output. Not part of the public API.
+    void transpose_block(unsigned char b[16]);
+
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "rijndael_keycache.h"
+#include <new>
+#include <random>
+
+namespace Rijndael
+{
+
+    static bool sameKey(const unsigned char * a, const unsigned char * b, size_t length)
+    {
+        unsigned char diff = 0;
+        for(size_t i = 0; i < length; i++) diff |= a[i] ^ b[i];
+        return diff == 0;
+    }
+
+    template<int KeyBits>
+    static void destroySchedule(const Cipher<KeyBits> * cipher, SecureArena * arena)
+    {
+        cipher->~Cipher();
+        if( arena != 0 && arena->owns(cipher) ) {
+            arena->deallocate((void *) cipher, sizeof(Cipher<KeyBits>));
+            return;
+        }
+        secure_zero((void *) cipher, sizeof(Cipher<KeyBits>));
+        ::operator delete((void *) cipher, std::align_val_t(alignof(Cipher<KeyBits>)));
+    }
+
+    template<int KeyBits>
+    KeyCache<KeyBits>::KeyCache(size_t capacity, Engine engine, SecureArena * arena)
+        : _capacity(capacity), _engine(selectEngine(engine)), _arena(arena), _hits(0), _misses(0), _evictions(0)
+    {
+        // Fingerprints are seeded per cache so colliding keys cannot be chosen
+        // in advance; full keys are still compared on every hit.
+        std::random_device random;
+        _seed = ((uint64_t) random() << 32) | random();
+    }
+
+    template<int KeyBits>
+    KeyCache<KeyBits>::~KeyCache()
+    {
+        clear();
+    }
+
+    template<int KeyBits>
+    uint64_t KeyCache<KeyBits>::_fingerprint(const uint8_t * key)
+    {
+        uint64_t h = _seed;
+
+        for(int i = 0; i < Cipher<KeyBits>::keyBytes; i += 8) {
+            uint64_t w;
+            memcpy(&w, key + i, 8);
+            h = (h ^ w) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 29;
+        }
+
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template<int KeyBits>
+    void KeyCache<KeyBits>::_erase(typename std::list<Entry>::iterator entry)
+    {
+        secure_zero(entry->key, sizeof(entry->key));
+        _index.erase(entry->fingerprint);
+        _entries.erase(entry);
+    }
+
+    template<int KeyBits>
+    typename KeyCache<KeyBits>::Handle KeyCache<KeyBits>::get(const uint8_t * key)
+    {
+        const uint64_t fingerprint = _fingerprint(key);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto found = _index.find(fingerprint);
+            if( found != _index.end() && sameKey(found->second->key, key, sizeof(found->second->key)) ) {
+                _entries.splice(_entries.begin(), _entries, found->second);
+                _hits++;
+                return found->second->cipher;
+            }
+        }
+
+        // Expand outside the lock so a miss never stalls other lookups.
+        _misses++;
+        SecureArena * arena = _arena;
+        void * memory = arena != 0 ? arena->allocate(sizeof(Cipher<KeyBits>)) : 0;
+        if( memory == 0 ) memory = ::operator new(sizeof(Cipher<KeyBits>), std::align_val_t(alignof(Cipher<KeyBits>)));
+        Handle cipher(new(memory) Cipher<KeyBits>(key, _engine), [arena](const Cipher<KeyBits> * c) { destroySchedule<KeyBits>(c, arena); });
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _index.find(fingerprint);
+        if( found != _index.end() ) {
+            // Another thread inserted the same key meanwhile; share its copy.
+            if( sameKey(found->second->key, key, sizeof(found->second->key)) ) {
+                _entries.splice(_entries.begin(), _entries, found->second);
+                return found->second->cipher;
+            }
+            _erase(found->second);
+            _evictions++;
+        }
+
+        if( _capacity == 0 ) return cipher;
+
+        while( _entries.size() >= _capacity ) {
+            _erase(std::prev(_entries.end()));
+            _evictions++;
+        }
+
+        _entries.push_front(Entry{ fingerprint, {}, cipher });
+        memcpy(_entries.front().key, key, sizeof(_entries.front().key));
+        _index[fingerprint] = _entries.begin();
+        return cipher;
+    }
+
+    template<int KeyBits>
+    void KeyCache<KeyBits>::clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while( !_entries.empty() ) _erase(_entries.begin());
+    }
+
+    template<int KeyBits>
+    size_t KeyCache<KeyBits>::size() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries.size();
+    }
+
+    template class KeyCache<128>;
+    template class KeyCache<192>;
+    template class KeyCache<256>;
+
+};
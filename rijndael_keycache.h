@@ -0,0 +1,74 @@
+#ifndef RIJNDAEL_KEYCACHE_H
+#define RIJNDAEL_KEYCACHE_H
+
+#include "rijndael.h"
+#include "rijndael_arena.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Rijndael
+{
+
+    // Bounded LRU cache of expanded key schedules for workloads that cycle
+    // through many keys. get() returns a shared, immutable Cipher holding both
+    // the encryption and decryption schedules; it stays valid after eviction
+    // for as long as the caller holds it. A schedule's memory is zeroized
+    // when its last reference is released. All methods are thread-safe.
+    //
+    // With an arena, schedules are placed in its locked memory, falling back
+    // to the heap while it is full. The arena must outlive the cache and
+    // every handle it returned.
+    template<int KeyBits = 128>
+    class KeyCache
+    {
+    public:
+        typedef std::shared_ptr<const Cipher<KeyBits>> Handle;
+
+    protected:
+        struct Entry
+        {
+            uint64_t fingerprint;
+            unsigned char key[Cipher<KeyBits>::keyBytes];
+            Handle cipher;
+        };
+
+        mutable std::mutex _mutex;
+        std::list<Entry> _entries;
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> _index;
+        size_t _capacity;
+        Engine _engine;
+        SecureArena * _arena;
+        uint64_t _seed;
+        std::atomic<uint64_t> _hits;
+        std::atomic<uint64_t> _misses;
+        std::atomic<uint64_t> _evictions;
+
+        uint64_t _fingerprint(const uint8_t * key);
+        void _erase(typename std::list<Entry>::iterator entry);
+
+    public:
+        explicit KeyCache(size_t capacity, Engine engine = Engine::Auto, SecureArena * arena = 0);
+        ~KeyCache();
+
+        // Looks up key (Cipher<KeyBits>::keyBytes bytes), expanding and
+        // inserting it on a miss.
+        Handle get(const uint8_t * key);
+        void clear();
+
+        size_t size() const;
+        size_t capacity() const { return _capacity; }
+        uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+        uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+        uint64_t evictions() const { return _evictions.load(std::memory_order_relaxed); }
+    };
+
+    extern template class KeyCache<128>;
+    extern template class KeyCache<192>;
+    extern template class KeyCache<256>;
+
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "rijndael_queue.h"
+#include "rijndael_internal.h"
+#include <stdexcept>
+#include <algorithm>
+
+namespace Rijndael
+{
+
+    EncryptQueue::EncryptQueue(size_t batchBytes, std::chrono::microseconds deadline)
+        : _pendingBytes(0), _batchBytes(batchBytes), _deadline(deadline), _flush(false), _stop(false)
+    {
+        _worker = std::thread(&EncryptQueue::_run, this);
+    }
+
+    EncryptQueue::~EncryptQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _worker.join();
+    }
+
+    std::future<std::string> EncryptQueue::submit(Key cipher, std::string plaintext)
+    {
+        if( !cipher ) {
+            std::promise<std::string> rejected;
+            rejected.set_exception(std::make_exception_ptr(std::invalid_argument("EncryptQueue: null cipher")));
+            return rejected.get_future();
+        }
+
+        Request request;
+        request.cipher = std::move(cipher);
+        request.plaintext = std::move(plaintext);
+        std::future<std::string> result = request.promise.get_future();
+        _submit(std::move(request));
+        return result;
+    }
+
+    bool EncryptQueue::submit(Key cipher, std::string plaintext, Callback done)
+    {
+        if( !cipher || !done ) return false;
+
+        Request request;
+        request.cipher = std::move(cipher);
+        request.plaintext = std::move(plaintext);
+        request.callback = std::move(done);
+        _submit(std::move(request));
+        return true;
+    }
+
+    void EncryptQueue::_submit(Request && request)
+    {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // The worker only needs waking to start the deadline clock or
+            // when the batch is full; otherwise it is already waiting for
+            // one of the two.
+            if( _pending.empty() ) _oldest = std::chrono::steady_clock::now();
+            wake = _pending.empty() || (_pendingBytes < _batchBytes && _pendingBytes + request.plaintext.size() >= _batchBytes);
+            _pendingBytes += request.plaintext.size();
+            _pending.push_back(std::move(request));
+        }
+        if( wake ) _wake.notify_one();
+    }
+
+    void EncryptQueue::flush()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _flush = true;
+        }
+        _wake.notify_one();
+    }
+
+    void EncryptQueue::setBatchBytes(size_t bytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _batchBytes = bytes;
+        }
+        _wake.notify_one();
+    }
+
+    void EncryptQueue::setDeadline(std::chrono::microseconds deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _deadline = deadline;
+        }
+        _wake.notify_one();
+    }
+
+    size_t EncryptQueue::batchBytes() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _batchBytes;
+    }
+
+    std::chrono::microseconds EncryptQueue::deadline() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _deadline;
+    }
+
+    void EncryptQueue::_run()
+    {
+        std::vector<Request> batch;
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        for(;;) {
+            if( _pending.empty() ) {
+                _flush = false;
+                if( _stop ) break;
+                _wake.wait(lock);
+                continue;
+            }
+
+            std::chrono::steady_clock::time_point due = _oldest + _deadline;
+            if( !_stop && !_flush && _pendingBytes < _batchBytes && std::chrono::steady_clock::now() < due ) {
+                _wake.wait_until(lock, due);
+                continue;
+            }
+
+            batch.swap(_pending);
+            _pendingBytes = 0;
+            _flush = false;
+
+            lock.unlock();
+            _process(batch);
+            batch.clear();
+            lock.lock();
+
+            // One oversized batch should not pin its buffer for the life of
+            // the queue; _process() has already zeroed it.
+            if( _buffer.size() > 2 * _batchBytes ) std::vector<unsigned char>().swap(_buffer);
+        }
+    }
+
+    void EncryptQueue::_process(std::vector<Request> & batch)
+    {
+        // Nothing may escape the worker thread. A failure to set up the
+        // batch (std::bad_alloc) fails every request not yet answered; for
+        // a single request, a future receives the exception and one thrown
+        // by a callback is dropped.
+        try {
+            // Group requests by cipher; each group is one encryptBlocks() call.
+            std::vector<size_t> order(batch.size());
+            for(size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return std::less<const BlockCipher *>()(batch[a].cipher.get(), batch[b].cipher.get());
+            });
+
+            for(size_t first = 0; first < order.size(); ) {
+                const BlockCipher & cipher = *batch[order[first]].cipher;
+                size_t last = first, blocks = 0;
+                for(; last < order.size() && batch[order[last]].cipher.get() == &cipher; last++) {
+                    blocks += (batch[order[last]].plaintext.size() + 15) / 16;
+                }
+
+                // The string API NUL-pads every message to whole blocks.
+                if( _buffer.size() < 16 * blocks ) _buffer.resize(16 * blocks);
+                unsigned char * p = _buffer.data();
+                for(size_t i = first; i < last; i++) {
+                    const std::string & plaintext = batch[order[i]].plaintext;
+                    size_t padded = (plaintext.size() + 15) / 16 * 16;
+                    memcpy(p, plaintext.data(), plaintext.size());
+                    memset(p + plaintext.size(), 0, padded - plaintext.size());
+                    p += padded;
+                }
+
+                for(size_t b = 0; b < blocks; b++) transpose_block(_buffer.data() + 16 * b);
+                cipher.encryptBlocks(_buffer.data(), _buffer.data(), blocks);
+                for(size_t b = 0; b < blocks; b++) transpose_block(_buffer.data() + 16 * b);
+
+                p = _buffer.data();
+                for(size_t i = first; i < last; i++) {
+                    Request & request = batch[order[i]];
+                    size_t padded = (request.plaintext.size() + 15) / 16 * 16;
+
+                    try {
+                        std::string ciphertext(base64_encoded_size(padded), '\0');
+                        base64_encode(p, padded, &ciphertext[0]);
+                        if( request.callback ) request.callback(std::move(ciphertext));
+                        else request.promise.set_value(std::move(ciphertext));
+                    } catch( ... ) {
+                        if( !request.callback ) request.promise.set_exception(std::current_exception());
+                    }
+                    request.answered = true;
+
+                    secure_zero(p, padded);
+                    secure_zero(&request.plaintext[0], request.plaintext.size());
+                    p += padded;
+                }
+
+                first = last;
+            }
+        } catch( ... ) {
+            secure_zero(_buffer.data(), _buffer.size());
+            for(size_t i = 0; i < batch.size(); i++) {
+                Request & request = batch[i];
+                if( request.answered ) continue;
+                secure_zero(&request.plaintext[0], request.plaintext.size());
+                if( !request.callback ) request.promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+};
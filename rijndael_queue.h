@@ -0,0 +1,88 @@
+#ifndef RIJNDAEL_QUEUE_H
+#define RIJNDAEL_QUEUE_H
+
+#include "rijndael.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Rijndael
+{
+
+    // Asynchronous string API encryption for many small requests. submit()
+    // queues a plaintext under any cipher (KeyCache handles convert) and
+    // returns at once; a worker thread collects requests into batches and
+    // hands every request of a batch that shares a cipher to a single
+    // encryptBlocks() call, so a handful of one- or two-block messages still
+    // fill the engine's parallel lanes. Results are byte-identical to
+    // Cipher::encrypt(std::string) and are delivered through a future or a
+    // callback that runs on the worker thread.
+    //
+    // A batch is started once batchBytes() of plaintext is waiting or the
+    // oldest request has waited deadline(), whichever comes first: a
+    // larger size or a longer deadline buys throughput with latency.
+    // flush() starts one right away. The destructor completes everything
+    // still queued. All methods are thread-safe.
+    //
+    // A null cipher or empty callback is rejected up front: the future holds
+    // std::invalid_argument, and the callback overload returns false
+    // without queueing. Exceptions never leave the worker thread. A
+    // future reports them, e.g. std::bad_alloc while building the
+    // ciphertext, while an exception thrown by a callback is caught and
+    // dropped, and the rest of the batch is still delivered. If the batch
+    // itself cannot be allocated, every future still waiting receives the
+    // exception and the remaining callbacks are not called.
+    class EncryptQueue
+    {
+    public:
+        typedef std::shared_ptr<const BlockCipher> Key;
+        typedef std::function<void(std::string && ciphertext)> Callback;
+
+    protected:
+        struct Request
+        {
+            Key cipher;
+            std::string plaintext;
+            std::promise<std::string> promise;
+            Callback callback;
+            bool answered = false;
+        };
+
+        mutable std::mutex _mutex;
+        std::condition_variable _wake;
+        std::vector<Request> _pending;
+        size_t _pendingBytes;
+        std::chrono::steady_clock::time_point _oldest;
+        size_t _batchBytes;
+        std::chrono::microseconds _deadline;
+        bool _flush;
+        bool _stop;
+        std::vector<unsigned char> _buffer;
+        std::thread _worker;
+
+        void _submit(Request && request);
+        void _run();
+        void _process(std::vector<Request> & batch);
+
+    public:
+        EncryptQueue(size_t batchBytes = 64 * 1024, std::chrono::microseconds deadline = std::chrono::microseconds(100));
+        ~EncryptQueue();
+
+        std::future<std::string> submit(Key cipher, std::string plaintext);
+        bool submit(Key cipher, std::string plaintext, Callback done);
+        void flush();
+
+        void setBatchBytes(size_t bytes);
+        void setDeadline(std::chrono::microseconds deadline);
+        size_t batchBytes() const;
+        std::chrono::microseconds deadline() const;
+    };
+
+};
+
+#endif
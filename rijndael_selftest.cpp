@@ -0,0 +1,79 @@
+#include "rijndael_selftest.h"
+#include "rijndael_gcm.h"
+
+namespace Rijndael
+{
+
+    static const unsigned char plaintext[16] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+
+    // FIPS-197 appendix C: key bytes 00 01 02 ... for each key size.
+    static const unsigned char ciphertexts[3][16] = {
+        { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a },
+        { 0xdd, 0xa9, 0x7c, 0xa4, 0x86, 0x4c, 0xdf, 0xe0, 0x6e, 0xaf, 0x70, 0xa0, 0xec, 0x0d, 0x71, 0x91 },
+        { 0x8e, 0xa2, 0xb7, 0xca, 0x51, 0x67, 0x45, 0xbf, 0xea, 0xfc, 0x49, 0x90, 0x4b, 0x49, 0x60, 0x89 }
+    };
+
+    template<int KeyBits>
+    static bool checkAppendixC(Engine engine, const unsigned char ciphertext[16])
+    {
+        unsigned char key[32], block[16];
+        for(int i = 0; i < 32; i++) key[i] = i;
+
+        Cipher<KeyBits> cipher(key, engine);
+        cipher.encryptBlocks(plaintext, block, 1);
+        if( memcmp(block, ciphertext, 16) != 0 ) return false;
+        cipher.decryptBlocks(block, block, 1);
+        return memcmp(block, plaintext, 16) == 0;
+    }
+
+    // GCM specification test case 4: 60 bytes of text with 20 bytes of AAD,
+    // so both a partial block and the tag are covered.
+    static bool checkGcm(Engine engine)
+    {
+        static const unsigned char key[16] = {
+            0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08
+        };
+        static const unsigned char iv[12] = { 0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88 };
+        static const unsigned char aad[20] = {
+            0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+            0xab, 0xad, 0xda, 0xd2
+        };
+        static const unsigned char text[60] = {
+            0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+            0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+            0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+            0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39
+        };
+        static const unsigned char expected[60] = {
+            0x42, 0x83, 0x1e, 0xc2, 0x21, 0x77, 0x74, 0x24, 0x4b, 0x72, 0x21, 0xb7, 0x84, 0xd0, 0xd4, 0x9c,
+            0xe3, 0xaa, 0x21, 0x2f, 0x2c, 0x02, 0xa4, 0xe0, 0x35, 0xc1, 0x7e, 0x23, 0x29, 0xac, 0xa1, 0x2e,
+            0x21, 0xd5, 0x14, 0xb2, 0x54, 0x66, 0x93, 0x1c, 0x7d, 0x8f, 0x6a, 0x5a, 0xac, 0x84, 0xaa, 0x05,
+            0x1b, 0xa3, 0x0b, 0x39, 0x6a, 0x0a, 0xac, 0x97, 0x3d, 0x58, 0xe0, 0x91
+        };
+        static const unsigned char expectedTag[16] = {
+            0x5b, 0xc9, 0x4f, 0xbc, 0x32, 0x21, 0xa5, 0xdb, 0x94, 0xfa, 0xe9, 0x5a, 0xe7, 0x12, 0x1a, 0x47
+        };
+
+        Cipher<128> cipher(key, engine);
+        const Gcm gcm(cipher);
+        unsigned char out[60], tag[16];
+
+        if( !gcm.encrypt(iv, sizeof(iv), aad, sizeof(aad), text, out, sizeof(text), tag) ) return false;
+        if( memcmp(out, expected, sizeof(out)) != 0 || memcmp(tag, expectedTag, sizeof(tag)) != 0 ) return false;
+        if( !gcm.decrypt(iv, sizeof(iv), aad, sizeof(aad), expected, out, sizeof(out), expectedTag) ) return false;
+        return memcmp(out, text, sizeof(text)) == 0;
+    }
+
+    bool startupTest(Engine engine)
+    {
+        if( selectEngine(engine) != engine ) return true;
+
+        return checkAppendixC<128>(engine, ciphertexts[0]) &&
+               checkAppendixC<192>(engine, ciphertexts[1]) &&
+               checkAppendixC<256>(engine, ciphertexts[2]) &&
+               checkGcm(engine);
+    }
+
+};
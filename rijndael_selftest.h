@@ -0,0 +1,18 @@
+#ifndef RIJNDAEL_SELFTEST_H
+#define RIJNDAEL_SELFTEST_H
+
+#include "rijndael.h"
+
+namespace Rijndael
+{
+
+    // Short known-answer check for programs to run before trusting an
+    // engine with data: the FIPS-197 appendix C vectors for every key size
+    // in both directions, and GCM test case 4. Returns true right away for
+    // engines the CPU cannot run, since selectEngine() never picks them.
+    // The full test corpus is the separate selftest program.
+    bool startupTest(Engine engine);
+
+};
+
+#endif
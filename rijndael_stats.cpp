@@ -0,0 +1,209 @@
+#include "rijndael_stats.h"
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace Rijndael
+{
+
+    namespace Stats
+    {
+
+        // One thread's slots. Only the owning thread stores to them; relaxed
+        // atomics just make the concurrent reads in snapshot() well defined.
+        struct ThreadSlots
+        {
+            std::atomic<uint64_t> counters[counterCount];
+            std::atomic<uint64_t> buckets[timerCount][bucketCount];
+            std::atomic<uint64_t> sums[timerCount];
+            std::atomic<uint64_t> maxima[timerCount];
+
+            ThreadSlots();
+            ~ThreadSlots();
+        };
+
+        // Live threads, plus what finished threads left behind.
+        struct Registry
+        {
+            std::mutex lock;
+            std::vector<ThreadSlots *> threads;
+            Snapshot retired = {};
+        };
+
+        static Registry & registry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        ThreadSlots::ThreadSlots()
+        {
+            for(int c = 0; c < counterCount; c++) counters[c].store(0, std::memory_order_relaxed);
+            for(int t = 0; t < timerCount; t++) {
+                for(int b = 0; b < bucketCount; b++) buckets[t][b].store(0, std::memory_order_relaxed);
+                sums[t].store(0, std::memory_order_relaxed);
+                maxima[t].store(0, std::memory_order_relaxed);
+            }
+
+            Registry & r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            r.threads.push_back(this);
+        }
+
+        // Adds one thread's timer t into a histogram.
+        static void fold(Histogram & h, const ThreadSlots & slots, int t)
+        {
+            for(int b = 0; b < bucketCount; b++) h.buckets[b] += slots.buckets[t][b].load(std::memory_order_relaxed);
+            h.sum += slots.sums[t].load(std::memory_order_relaxed);
+            uint64_t max = slots.maxima[t].load(std::memory_order_relaxed);
+            if( max > h.max ) h.max = max;
+        }
+
+        ThreadSlots::~ThreadSlots()
+        {
+            Registry & r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+
+            for(int c = 0; c < counterCount; c++) r.retired.counters[c] += counters[c].load(std::memory_order_relaxed);
+            for(int t = 0; t < timerCount; t++) fold(r.retired.timers[t], *this, t);
+
+            for(size_t i = 0; i < r.threads.size(); i++) {
+                if( r.threads[i] == this ) {
+                    r.threads[i] = r.threads.back();
+                    r.threads.pop_back();
+                    break;
+                }
+            }
+        }
+
+        static ThreadSlots & slots()
+        {
+            static thread_local ThreadSlots slots;
+            return slots;
+        }
+
+        static inline void bump(std::atomic<uint64_t> & slot, uint64_t n)
+        {
+            slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        void add(Counter counter, uint64_t n)
+        {
+            bump(slots().counters[counter], n);
+        }
+
+        void record(Timer timer, uint64_t nanoseconds)
+        {
+            ThreadSlots & s = slots();
+            bump(s.buckets[timer][bucketIndex(nanoseconds)], 1);
+            bump(s.sums[timer], nanoseconds);
+            if( nanoseconds > s.maxima[timer].load(std::memory_order_relaxed) ) s.maxima[timer].store(nanoseconds, std::memory_order_relaxed);
+        }
+
+        int bucketIndex(uint64_t nanoseconds)
+        {
+            if( nanoseconds < 2 * subBuckets ) return (int) nanoseconds;
+
+            int e = 63 - __builtin_clzll(nanoseconds);
+            int index = (e - 3) * subBuckets + (int)(nanoseconds >> (e - 4)) - subBuckets;
+            return index < bucketCount ? index : bucketCount - 1;
+        }
+
+        uint64_t bucketValue(int index)
+        {
+            if( index < 2 * subBuckets ) return index;
+
+            int e = index / subBuckets + 3;
+            return (uint64_t)(index % subBuckets + subBuckets) << (e - 4);
+        }
+
+        uint64_t Histogram::count() const
+        {
+            uint64_t n = 0;
+            for(int b = 0; b < bucketCount; b++) n += buckets[b];
+            return n;
+        }
+
+        uint64_t Histogram::percentile(double q) const
+        {
+            uint64_t n = count();
+            if( n == 0 ) return 0;
+
+            uint64_t rank = (uint64_t)(q * n + 0.5);
+            if( rank == 0 ) rank = 1;
+            uint64_t seen = 0;
+            for(int b = 0; b < bucketCount; b++) {
+                seen += buckets[b];
+                if( seen >= rank ) return bucketValue(b);
+            }
+            return bucketValue(bucketCount - 1);
+        }
+
+        Snapshot snapshot()
+        {
+            Registry & r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            Snapshot s = r.retired;
+
+            for(size_t i = 0; i < r.threads.size(); i++) {
+                ThreadSlots & t = *r.threads[i];
+                for(int c = 0; c < counterCount; c++) s.counters[c] += t.counters[c].load(std::memory_order_relaxed);
+                for(int h = 0; h < timerCount; h++) fold(s.timers[h], t, h);
+            }
+
+            return s;
+        }
+
+        const char * counterName(Counter counter)
+        {
+            static const char * names[counterCount] = {
+                "key_expansions", "blocks_encrypted", "blocks_decrypted", "string_bytes", "base64_bytes", "bulk_bytes"
+            };
+            return names[counter];
+        }
+
+        const char * timerName(Timer timer)
+        {
+            static const char * names[timerCount] = {
+                "key_expansion", "string_encrypt", "string_decrypt", "base64_encode", "base64_decode", "bulk_ecb", "bulk_ctr", "bulk_xts"
+            };
+            return names[timer];
+        }
+
+        // Counters, then per timer the sample count, exact total, percentiles
+        // and exact maximum in nanoseconds and the non-empty buckets as
+        // [value, count] pairs.
+        std::string toJson(const Snapshot & snapshot)
+        {
+            std::ostringstream out;
+
+            out << "{\"counters\": {";
+            for(int c = 0; c < counterCount; c++) {
+                out << (c ? ", " : "") << "\"" << counterName((Counter) c) << "\": " << snapshot.counters[c];
+            }
+
+            out << "}, \"timers\": {";
+            for(int t = 0; t < timerCount; t++) {
+                const Histogram & h = snapshot.timers[t];
+                out << (t ? ", " : "") << "\"" << timerName((Timer) t) << "\": {\"count\": " << h.count()
+                    << ", \"total_ns\": " << h.total() << ", \"p50_ns\": " << h.percentile(0.5)
+                    << ", \"p99_ns\": " << h.percentile(0.99) << ", \"p999_ns\": " << h.percentile(0.999)
+                    << ", \"max_ns\": " << h.max << ", \"buckets\": [";
+
+                bool first = true;
+                for(int b = 0; b < bucketCount; b++) {
+                    if( h.buckets[b] == 0 ) continue;
+                    out << (first ? "" : ", ") << "[" << bucketValue(b) << ", " << h.buckets[b] << "]";
+                    first = false;
+                }
+                out << "]}";
+            }
+            out << "}}";
+
+            return out.str();
+        }
+
+    };
+
+};
@@ -0,0 +1,111 @@
+#ifndef RIJNDAEL_STATS_H
+#define RIJNDAEL_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+namespace Rijndael
+{
+
+    // Optional instrumentation, compiled in with -DRIJNDAEL_STATS. Every
+    // thread counts into its own slots, which only it writes, so recording
+    // takes no locks and no atomic read-modify-writes; snapshot() sums all
+    // threads, live and finished. Without RIJNDAEL_STATS the recording
+    // macros expand to nothing and snapshot() stays all zero.
+    namespace Stats
+    {
+
+#ifdef RIJNDAEL_STATS
+        static constexpr bool enabled = true;
+#else
+        static constexpr bool enabled = false;
+#endif
+
+        enum Counter
+        {
+            KeyExpansions,
+            BlocksEncrypted,
+            BlocksDecrypted,
+            StringBytes,
+            Base64Bytes,
+            BulkBytes,
+            counterCount
+        };
+
+        enum Timer
+        {
+            KeyExpansion,
+            StringEncrypt,
+            StringDecrypt,
+            Base64Encode,
+            Base64Decode,
+            BulkEcb,
+            BulkCtr,
+            BulkXts,
+            timerCount
+        };
+
+        // Log-linear (HDR-style) latency buckets in nanoseconds: exact below
+        // 32 ns, then 16 buckets per power of two, so any value is off by at
+        // most 1/16. Values from 2^48 ns up share the last bucket.
+        static const int subBuckets = 16;
+        static const int bucketCount = (48 - 3) * subBuckets;
+
+        int bucketIndex(uint64_t nanoseconds);
+        uint64_t bucketValue(int index);
+
+        // sum and max are kept exactly beside the buckets, since bucket
+        // values round down.
+        struct Histogram
+        {
+            uint64_t buckets[bucketCount];
+            uint64_t sum;
+            uint64_t max;
+
+            uint64_t count() const;
+            uint64_t total() const { return sum; }
+            // Smallest recorded bucket value with at least q of the samples
+            // at or below it, q in [0, 1].
+            uint64_t percentile(double q) const;
+        };
+
+        struct Snapshot
+        {
+            uint64_t counters[counterCount];
+            Histogram timers[timerCount];
+        };
+
+        Snapshot snapshot();
+        std::string toJson(const Snapshot & snapshot);
+        const char * counterName(Counter counter);
+        const char * timerName(Timer timer);
+
+        void add(Counter counter, uint64_t n);
+        void record(Timer timer, uint64_t nanoseconds);
+
+        class ScopedTimer
+        {
+        protected:
+            Timer _timer;
+            std::chrono::steady_clock::time_point _start;
+
+        public:
+            ScopedTimer(Timer timer) : _timer(timer), _start(std::chrono::steady_clock::now()) {}
+            ~ScopedTimer() { record(_timer, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count()); }
+        };
+
+    };
+
+};
+
+#ifdef RIJNDAEL_STATS
+#define RIJNDAEL_COUNT(counter, n) ::Rijndael::Stats::add(::Rijndael::Stats::counter, n)
+#define RIJNDAEL_TIME(timer) ::Rijndael::Stats::ScopedTimer rijndaelTimer_(::Rijndael::Stats::timer)
+#else
+#define RIJNDAEL_COUNT(counter, n) ((void)0)
+#define RIJNDAEL_TIME(timer) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#include "rijndael_stream.h"
+
+namespace Rijndael
+{
+
+    size_t Encryptor::update(const uint8_t * in, size_t length, uint8_t * out)
+    {
+        size_t written = 0;
+
+        if( _partialLength > 0 ) {
+            size_t n = 16 - _partialLength < length ? 16 - _partialLength : length;
+            memcpy(_partial + _partialLength, in, n);
+            _partialLength += n;
+            in += n;
+            length -= n;
+            if( _partialLength < 16 ) return 0;
+
+            _cipher.encryptBlocks(_partial, out, 1);
+            _partialLength = 0;
+            out += 16;
+            written += 16;
+        }
+
+        size_t blocks = length / 16;
+        _cipher.encryptBlocks(in, out, blocks);
+        written += 16 * blocks;
+
+        _partialLength = length % 16;
+        memcpy(_partial, in + 16 * blocks, _partialLength);
+
+        return written;
+    }
+
+    size_t Encryptor::finalize(uint8_t out[16])
+    {
+        unsigned char pad = 16 - _partialLength;
+        memset(_partial + _partialLength, pad, pad);
+        _cipher.encryptBlocks(_partial, out, 1);
+        secure_zero(_partial, sizeof(_partial));
+        _partialLength = 0;
+
+        return 16;
+    }
+
+    size_t Decryptor::update(const uint8_t * in, size_t length, uint8_t * out)
+    {
+        size_t written = 0;
+
+        while( length > 0 ) {
+            // A buffered full block is only decrypted once more input shows
+            // it is not the last one.
+            if( _partialLength == 16 ) {
+                _cipher.decryptBlocks(_partial, out, 1);
+                _partialLength = 0;
+                out += 16;
+                written += 16;
+            }
+
+            if( _partialLength > 0 || length <= 16 ) {
+                size_t n = 16 - _partialLength < length ? 16 - _partialLength : length;
+                memcpy(_partial + _partialLength, in, n);
+                _partialLength += n;
+                in += n;
+                length -= n;
+                continue;
+            }
+
+            size_t blocks = (length - 1) / 16;
+            _cipher.decryptBlocks(in, out, blocks);
+            in += 16 * blocks;
+            out += 16 * blocks;
+            length -= 16 * blocks;
+            written += 16 * blocks;
+        }
+
+        return written;
+    }
+
+    bool Decryptor::finalize(uint8_t out[16], size_t & length)
+    {
+        length = 0;
+        if( _partialLength != 16 ) {
+            _partialLength = 0;
+            return false;
+        }
+
+        unsigned char block[16];
+        _cipher.decryptBlocks(_partial, block, 1);
+        secure_zero(_partial, sizeof(_partial));
+        _partialLength = 0;
+
+        bool ok = pkcs7_unpad(block, length);
+        if( ok ) memcpy(out, block, length);
+        secure_zero(block, sizeof(block));
+        return ok;
+    }
+
+    bool pkcs7_unpad(const unsigned char block[16], size_t & length)
+    {
+        // Check every padding byte regardless of where a mismatch is.
+        unsigned char pad = block[15];
+        unsigned char bad = (pad == 0) | (pad > 16);
+        for(int i = 0; i < 16; i++) {
+            unsigned char inPad = (unsigned char)(15 - i) < pad;
+            bad |= inPad & (block[i] != pad);
+        }
+
+        length = bad ? 0 : 16 - pad;
+        return !bad;
+    }
+
+};
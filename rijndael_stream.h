@@ -0,0 +1,55 @@
+#ifndef RIJNDAEL_STREAM_H
+#define RIJNDAEL_STREAM_H
+
+#include "rijndael.h"
+
+namespace Rijndael
+{
+
+    // Incremental block encryption with PKCS#7 padding. Input may arrive in
+    // pieces of any size; at most one partial block is carried between calls,
+    // so memory use does not grow with the input. update() writes whole
+    // blocks to out (updateSize() bytes) and finalize() writes the padded
+    // last block.
+    class Encryptor
+    {
+    protected:
+        const BlockCipher & _cipher;
+        unsigned char _partial[16];
+        size_t _partialLength;
+
+    public:
+        Encryptor(const BlockCipher & cipher) : _cipher(cipher), _partialLength(0) {}
+        ~Encryptor() { secure_zero(_partial, sizeof(_partial)); }
+
+        size_t updateSize(size_t length) const { return (_partialLength + length) / 16 * 16; }
+        size_t update(const uint8_t * in, size_t length, uint8_t * out);
+        size_t finalize(uint8_t out[16]);
+    };
+
+    // The last block is held back until finalize() because only then is it
+    // known to carry the padding. finalize() returns false if the padding is
+    // malformed or the ciphertext was not a whole number of blocks.
+    class Decryptor
+    {
+    protected:
+        const BlockCipher & _cipher;
+        unsigned char _partial[16];
+        size_t _partialLength;
+
+    public:
+        Decryptor(const BlockCipher & cipher) : _cipher(cipher), _partialLength(0) {}
+        ~Decryptor() { secure_zero(_partial, sizeof(_partial)); }
+
+        size_t updateSize(size_t length) const { return _partialLength + length == 0 ? 0 : (_partialLength + length - 1) / 16 * 16; }
+        size_t update(const uint8_t * in, size_t length, uint8_t * out);
+        bool finalize(uint8_t out[16], size_t & length);
+    };
+
+    // Checks the PKCS#7 padding of a decrypted last block in constant time
+    // and sets length to the number of data bytes it holds.
+    bool pkcs7_unpad(const unsigned char block[16], size_t & length);
+
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "rijndael_threadpool.h"
+
+namespace Rijndael
+{
+
+    // The pool whose tasks the current thread is running, to spot nested
+    // run() calls that would otherwise wait on _runMutex forever.
+    static thread_local const ThreadPool * runningPool = 0;
+
+    ThreadPool::ThreadPool(unsigned int threads) : _task(0), _busy(0), _generation(0), _stop(false)
+    {
+        if( threads == 0 ) threads = 1;
+        _shares.reset(new Share[threads]);
+        for(unsigned int i = 0; i < threads; i++) _shares[i].begin = _shares[i].end = 0;
+
+        // The caller of run() works too, so one thread fewer is spawned. It
+        // owns the last share.
+        for(unsigned int i = 1; i < threads; i++) {
+            _workers.push_back(std::thread(&ThreadPool::_worker, this, i - 1));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for(size_t i = 0; i < _workers.size(); i++) _workers[i].join();
+    }
+
+    bool ThreadPool::_take(unsigned int self, size_t & task)
+    {
+        Share & share = _shares[self];
+        std::lock_guard<std::mutex> lock(share.lock);
+        if( share.begin == share.end ) return false;
+        task = share.begin++;
+        return true;
+    }
+
+    bool ThreadPool::_steal(unsigned int self, size_t & task)
+    {
+        const unsigned int n = size();
+
+        for(unsigned int k = 1; k < n; k++) {
+            Share & victim = _shares[(self + k) % n];
+            size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(victim.lock);
+                size_t left = victim.end - victim.begin;
+                if( left == 0 ) continue;
+                end = victim.end;
+                begin = end - (left + 1) / 2;
+                victim.end = begin;
+            }
+
+            // Only the owner refills its share and it is empty here, so the
+            // stolen range can simply replace it.
+            Share & own = _shares[self];
+            std::lock_guard<std::mutex> lock(own.lock);
+            own.begin = begin + 1;
+            own.end = end;
+            task = begin;
+            return true;
+        }
+
+        return false;
+    }
+
+    void ThreadPool::_drain(unsigned int self)
+    {
+        const ThreadPool * outer = runningPool;
+        runningPool = this;
+
+        size_t i;
+        while( _take(self, i) || _steal(self, i) ) (*_task)(i);
+
+        runningPool = outer;
+    }
+
+    void ThreadPool::_worker(unsigned int self)
+    {
+        unsigned long seen = 0;
+
+        for(;;) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&] { return _stop || _generation != seen; });
+                if( _stop ) return;
+                seen = _generation;
+            }
+
+            _drain(self);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if( --_busy == 0 ) _done.notify_one();
+        }
+    }
+
+    void ThreadPool::run(size_t tasks, const std::function<void(size_t)> & task)
+    {
+        if( runningPool == this ) {
+            for(size_t i = 0; i < tasks; i++) task(i);
+            return;
+        }
+
+        std::lock_guard<std::mutex> serial(_runMutex);
+
+        if( _workers.empty() || tasks <= 1 ) {
+            for(size_t i = 0; i < tasks; i++) task(i);
+            return;
+        }
+
+        const unsigned int n = size();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for(unsigned int i = 0; i < n; i++) {
+                std::lock_guard<std::mutex> share(_shares[i].lock);
+                _shares[i].begin = tasks * i / n;
+                _shares[i].end = tasks * (i + 1) / n;
+            }
+            _task = &task;
+            _busy = _workers.size();
+            _generation++;
+        }
+        _wake.notify_all();
+
+        _drain(n - 1);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [&] { return _busy == 0; });
+        _task = 0;
+    }
+
+    void ThreadPool::runChunks(size_t length, size_t chunk, const std::function<void(size_t, size_t)> & task)
+    {
+        if( chunk == 0 ) chunk = length;
+        if( length == 0 ) return;
+
+        run((length + chunk - 1) / chunk, [&](size_t i) {
+            size_t offset = i * chunk;
+            task(offset, length - offset < chunk ? length - offset : chunk);
+        });
+    }
+
+};
@@ -0,0 +1,68 @@
+#ifndef RIJNDAEL_THREADPOOL_H
+#define RIJNDAEL_THREADPOOL_H
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Rijndael
+{
+
+    // Fixed set of worker threads for splitting bulk work. run() hands out
+    // task indices [0, tasks) to the workers and the calling thread, and
+    // returns once every task has finished. Calls to run() are serialized.
+    //
+    // Scheduling is work-stealing: each thread starts on its own contiguous
+    // share of the indices and takes them in order, and a thread that runs
+    // dry steals the upper half of another thread's remaining share. Threads
+    // thus walk adjacent memory while load still evens out.
+    class ThreadPool
+    {
+    protected:
+        struct alignas(64) Share
+        {
+            std::mutex lock;
+            size_t begin;
+            size_t end;
+        };
+
+        std::vector<std::thread> _workers;
+        std::unique_ptr<Share[]> _shares;
+        std::mutex _runMutex;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        const std::function<void(size_t)> * _task;
+        unsigned int _busy;
+        unsigned long _generation;
+        bool _stop;
+
+        void _worker(unsigned int self);
+        void _drain(unsigned int self);
+        bool _take(unsigned int self, size_t & task);
+        bool _steal(unsigned int self, size_t & task);
+
+    public:
+        explicit ThreadPool(unsigned int threads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        unsigned int size() const { return _workers.size() + 1; }
+
+        // A task may call run() on its own pool again. Since the pool is
+        // already busy with the outer call, such a nested call runs its
+        // tasks serially on the calling thread instead of blocking.
+        void run(size_t tasks, const std::function<void(size_t)> & task);
+
+        // Cuts [0, length) into pieces of chunk bytes (the last may be short)
+        // and runs task(offset, length) for each piece through run().
+        void runChunks(size_t length, size_t chunk, const std::function<void(size_t, size_t)> & task);
+    };
+
+};
+
+#endif
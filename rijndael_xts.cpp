@@ -0,0 +1,174 @@
+#include "rijndael_xts.h"
+
+namespace Rijndael
+{
+
+    static const size_t xtsBatchBlocks = 32;
+
+#ifdef __SSE2__
+
+    // Multiplies a little-endian 128-bit tweak by x: every 32-bit lane
+    // shifts left by one, takes the bit shifted out of the lane below, and
+    // the bit leaving the top folds back into the bottom as 0x87.
+    static inline __m128i gfDouble(__m128i t)
+    {
+        __m128i carry = _mm_shuffle_epi32(_mm_srai_epi32(t, 31), 0x93);
+        carry = _mm_and_si128(carry, _mm_set_epi32(1, 1, 1, 0x87));
+        return _mm_xor_si128(_mm_slli_epi32(t, 1), carry);
+    }
+
+    // Writes the masks for blocks into masks and the masked input into
+    // out, then advances tweak past them.
+    static inline void whiten(unsigned char tweak[16], const uint8_t * in, unsigned char * out, unsigned char * masks, size_t blocks)
+    {
+        __m128i t = _mm_loadu_si128((const __m128i *) tweak);
+        for(size_t i = 0; i < blocks; i++) {
+            _mm_storeu_si128((__m128i *) (masks + 16 * i), t);
+            _mm_storeu_si128((__m128i *) (out + 16 * i), _mm_xor_si128(_mm_loadu_si128((const __m128i *) (in + 16 * i)), t));
+            t = gfDouble(t);
+        }
+        _mm_storeu_si128((__m128i *) tweak, t);
+    }
+
+    static inline void nextTweak(unsigned char tweak[16])
+    {
+        _mm_storeu_si128((__m128i *) tweak, gfDouble(_mm_loadu_si128((const __m128i *) tweak)));
+    }
+
+    static inline void xorBlocks(uint8_t * out, const unsigned char * a, const unsigned char * b, size_t blocks)
+    {
+        for(size_t i = 0; i < blocks; i++) {
+            __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *) (a + 16 * i)), _mm_loadu_si128((const __m128i *) (b + 16 * i)));
+            _mm_storeu_si128((__m128i *) (out + 16 * i), x);
+        }
+    }
+
+#else
+
+    static inline void nextTweak(unsigned char t[16])
+    {
+        unsigned char carry = 0;
+        for(int i = 0; i < 16; i++) {
+            unsigned char next = t[i] >> 7;
+            t[i] = (t[i] << 1) | carry;
+            carry = next;
+        }
+        if( carry ) t[0] ^= 0x87;
+    }
+
+    static inline void whiten(unsigned char tweak[16], const uint8_t * in, unsigned char * out, unsigned char * masks, size_t blocks)
+    {
+        for(size_t i = 0; i < blocks; i++) {
+            memcpy(masks + 16 * i, tweak, 16);
+            for(int j = 0; j < 16; j++) out[16 * i + j] = in[16 * i + j] ^ tweak[j];
+            nextTweak(tweak);
+        }
+    }
+
+    static inline void xorBlocks(uint8_t * out, const unsigned char * a, const unsigned char * b, size_t blocks)
+    {
+        for(size_t i = 0; i < 16 * blocks; i++) out[i] = a[i] ^ b[i];
+    }
+
+#endif
+
+    // XEX over whole blocks: out = E(in ^ T) ^ T, with T advanced per block.
+    static void cryptBlocks(const BlockCipher & cipher, bool encrypting, unsigned char tweak[16], const uint8_t * in, uint8_t * out, size_t blocks)
+    {
+        unsigned char buffer[xtsBatchBlocks * 16];
+        unsigned char masks[xtsBatchBlocks * 16];
+
+        while( blocks > 0 ) {
+            size_t n = blocks < xtsBatchBlocks ? blocks : xtsBatchBlocks;
+
+            whiten(tweak, in, buffer, masks, n);
+            if( encrypting ) cipher.encryptBlocks(buffer, buffer, n);
+            else cipher.decryptBlocks(buffer, buffer, n);
+            xorBlocks(out, buffer, masks, n);
+
+            in += 16 * n;
+            out += 16 * n;
+            blocks -= n;
+        }
+
+        secure_zero(buffer, sizeof(buffer));
+        secure_zero(masks, sizeof(masks));
+    }
+
+    void Xts::_crypt(bool encrypting, const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        size_t blocks = length / 16;
+        size_t tail = length % 16;
+        unsigned char t[16];
+
+        _tweakCipher.encryptBlocks(tweak, t, 1);
+
+        if( tail == 0 ) {
+            cryptBlocks(_dataCipher, encrypting, t, in, out, blocks);
+            secure_zero(t, sizeof(t));
+            return;
+        }
+
+        // Ciphertext stealing: the last full block and the partial block
+        // swap places, with the partial block padded from the other's output.
+        size_t last = 16 * (blocks - 1);
+        unsigned char block[16], partial[16];
+
+        cryptBlocks(_dataCipher, encrypting, t, in, out, blocks - 1);
+        memcpy(partial, in + last + 16, tail);
+
+        if( encrypting ) {
+            cryptBlocks(_dataCipher, true, t, in + last, block, 1);
+        } else {
+            // Decryption undoes the swap, so the last full block uses the
+            // following tweak and the stolen block the current one.
+            unsigned char next[16];
+            memcpy(next, t, 16);
+            nextTweak(next);
+            cryptBlocks(_dataCipher, false, next, in + last, block, 1);
+            secure_zero(next, sizeof(next));
+        }
+
+        memcpy(partial + tail, block + tail, 16 - tail);
+        memcpy(out + last + 16, block, tail);
+        cryptBlocks(_dataCipher, encrypting, t, partial, out + last, 1);
+
+        secure_zero(t, sizeof(t));
+        secure_zero(block, sizeof(block));
+        secure_zero(partial, sizeof(partial));
+    }
+
+    bool Xts::encrypt(const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        if( length < 16 ) return false;
+        _crypt(true, tweak, in, out, length);
+        return true;
+    }
+
+    bool Xts::decrypt(const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        if( length < 16 ) return false;
+        _crypt(false, tweak, in, out, length);
+        return true;
+    }
+
+    static inline void sectorTweak(uint64_t sector, unsigned char tweak[16])
+    {
+        for(int i = 0; i < 16; i++, sector >>= 8) tweak[i] = i < 8 ? (unsigned char) sector : 0;
+    }
+
+    bool Xts::encryptSector(uint64_t sector, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        unsigned char tweak[16];
+        sectorTweak(sector, tweak);
+        return encrypt(tweak, in, out, length);
+    }
+
+    bool Xts::decryptSector(uint64_t sector, const uint8_t * in, uint8_t * out, size_t length) const
+    {
+        unsigned char tweak[16];
+        sectorTweak(sector, tweak);
+        return decrypt(tweak, in, out, length);
+    }
+
+};
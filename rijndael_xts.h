@@ -0,0 +1,41 @@
+#ifndef RIJNDAEL_XTS_H
+#define RIJNDAEL_XTS_H
+
+#include "rijndael.h"
+
+namespace Rijndael
+{
+
+    // XTS-AES (IEEE 1619 / NIST SP 800-38E) for sector-level storage
+    // encryption. dataCipher encrypts the data and tweakCipher, keyed
+    // independently, turns the 128-bit tweak into the first mask; the mask
+    // is multiplied by x in GF(2^128) for each following block. Sector
+    // lengths that are not a multiple of 16 use ciphertext stealing, so
+    // output is always as long as input.
+    //
+    // Sectors are independent and Xts holds no state besides the two
+    // ciphers, so sectors may be processed concurrently and in any order.
+    // Calls return false for sectors shorter than one block.
+    class Xts
+    {
+    protected:
+        const BlockCipher & _dataCipher;
+        const BlockCipher & _tweakCipher;
+
+        void _crypt(bool encrypting, const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const;
+
+    public:
+        Xts(const BlockCipher & dataCipher, const BlockCipher & tweakCipher) : _dataCipher(dataCipher), _tweakCipher(tweakCipher) {}
+
+        // tweak is the 16-byte data unit number as specified by IEEE 1619.
+        bool encrypt(const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const;
+        bool decrypt(const uint8_t tweak[16], const uint8_t * in, uint8_t * out, size_t length) const;
+
+        // The sector number as a 128-bit little-endian tweak.
+        bool encryptSector(uint64_t sector, const uint8_t * in, uint8_t * out, size_t length) const;
+        bool decryptSector(uint64_t sector, const uint8_t * in, uint8_t * out, size_t length) const;
+    };
+
+};
+
+#endif
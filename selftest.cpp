@@ -0,0 +1,1151 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rijndael.h"
+#include "rijndael_cbc.h"
+#include "rijndael_ctr.h"
+#include "rijndael_gcm.h"
+#include "rijndael_threadpool.h"
+#include "rijndael_xts.h"
+
+using namespace Rijndael;
+
+// Checks every engine the CPU has and exits non-zero on the first failure.
+// The library itself only carries the short startupTest().
+//
+// knownAnswerTest runs the FIPS-197 example vectors and the NIST AESAVS
+// GFSbox, KeySbox, VarTxt, VarKey and ECB Monte Carlo tests for every key
+// size, in both directions, then the published vectors for the modes:
+// SP 800-38A CBC and CTR, the GCM specification test cases (including
+// rejection of a tampered tag, ciphertext or AAD and of messages past
+// the GCM length limit) and IEEE 1619 XTS.
+//
+// differentialTest compares the engine against Engine::Reference, the
+// plain FIPS-197 round functions, on random keys of every size and random
+// batches of blocks, through the batch, in-place and Block calls. Each
+// iteration uses a fresh key; seed makes runs repeatable.
+//
+// allocationTest checks that the string_view overloads of the string API
+// never allocate.
+//
+// threadPoolTest has several threads submit rounds of run() and
+// runChunks() calls with uneven task costs to one ThreadPool, so that
+// work-stealing kicks in. It checks that every task ran exactly once and
+// that the results match a serial run, including for nested run() calls.
+//
+// cipherSharingTest builds one Cipher per engine and key size and has
+// several threads run single-block, batch and string API calls on that one
+// instance at once, checking every result against a serial run.
+//
+// usage: selftest [iterations], the differential iterations per engine
+// (256 by default).
+
+// Every operator new is replaced to count calls per thread, so that
+// allocationTest can check that the string_view API never allocates.
+static thread_local uint64_t allocationCount = 0;
+
+static uint64_t allocations() { return allocationCount; }
+
+void * operator new(size_t size)
+{
+    allocationCount++;
+    void * memory = malloc(size ? size : 1);
+    if( memory == 0 ) throw std::bad_alloc();
+    return memory;
+}
+
+void * operator new(size_t size, std::align_val_t alignment)
+{
+    allocationCount++;
+    size_t a = (size_t) alignment < sizeof(void *) ? sizeof(void *) : (size_t) alignment;
+    void * memory = 0;
+    if( posix_memalign(&memory, a, size ? size : 1) != 0 ) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void * memory) noexcept { free(memory); }
+void operator delete(void * memory, size_t) noexcept { free(memory); }
+void operator delete(void * memory, std::align_val_t) noexcept { free(memory); }
+void operator delete(void * memory, size_t, std::align_val_t) noexcept { free(memory); }
+
+static void fromHex(const char * hex, unsigned char * out)
+{
+    for(size_t i = 0; hex[2 * i]; i++) {
+        unsigned char b = 0;
+        for(int j = 0; j < 2; j++) {
+            char c = hex[2 * i + j];
+            b = (b << 4) | (c <= '9' ? c - '0' : c - 'a' + 10);
+        }
+        out[i] = b;
+    }
+}
+
+// The first n bits set, the rest clear.
+static void leadingOnes(unsigned char * out, size_t bytes, size_t n)
+{
+    for(size_t i = 0; i < bytes; i++) out[i] = n >= 8 * (i + 1) ? 0xff : n <= 8 * i ? 0 : (unsigned char)(0xff << (8 - (n - 8 * i)));
+}
+
+template<int KeyBits>
+static bool check(Engine engine, const unsigned char * key, const unsigned char plaintext[16], const unsigned char ciphertext[16])
+{
+    Cipher<KeyBits> cipher(key, engine);
+    unsigned char block[16];
+
+    cipher.encryptBlocks(plaintext, block, 1);
+    if( memcmp(block, ciphertext, 16) != 0 ) return false;
+    cipher.decryptBlocks(ciphertext, block, 1);
+    return memcmp(block, plaintext, 16) == 0;
+}
+
+template<int KeyBits>
+static bool checkHex(Engine engine, const char * key, const char * plaintext, const char * ciphertext)
+{
+    unsigned char k[32], p[16], c[16];
+    fromHex(key, k);
+    fromHex(plaintext, p);
+    fromHex(ciphertext, c);
+    return check<KeyBits>(engine, k, p, c);
+}
+
+struct Vector
+{
+    int keyBits;
+    const char * key;
+    const char * plaintext;
+    const char * ciphertext;
+};
+
+// FIPS-197 appendices B and C, then the AESAVS GFSbox and KeySbox sets.
+static const Vector vectors[] = {
+    { 128, "2b7e151628aed2a6abf7158809cf4f3c", "3243f6a8885a308d313198a2e0370734", "3925841d02dc09fbdc118597196a0b32" },
+    { 128, "000102030405060708090a0b0c0d0e0f", "00112233445566778899aabbccddeeff", "69c4e0d86a7b0430d8cdb78070b4c55a" },
+    { 192, "000102030405060708090a0b0c0d0e0f1011121314151617", "00112233445566778899aabbccddeeff", "dda97ca4864cdfe06eaf70a0ec0d7191" },
+    { 256, "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "00112233445566778899aabbccddeeff", "8ea2b7ca516745bfeafc49904b496089" },
+
+    { 128, "00000000000000000000000000000000", "f34481ec3cc627bacd5dc3fb08f273e6", "0336763e966d92595a567cc9ce537f5e" },
+    { 128, "00000000000000000000000000000000", "9798c4640bad75c7c3227db910174e72", "a9a1631bf4996954ebc093957b234589" },
+    { 128, "00000000000000000000000000000000", "96ab5c2ff612d9dfaae8c31f30c42168", "ff4f8391a6a40ca5b25d23bedd44a597" },
+    { 128, "00000000000000000000000000000000", "6a118a874519e64e9963798a503f1d35", "dc43be40be0e53712f7e2bf5ca707209" },
+    { 128, "00000000000000000000000000000000", "cb9fceec81286ca3e989bd979b0cb284", "92beedab1895a94faa69b632e5cc47ce" },
+    { 128, "00000000000000000000000000000000", "b26aeb1874e47ca8358ff22378f09144", "459264f4798f6a78bacb89c15ed3d601" },
+    { 128, "00000000000000000000000000000000", "58c8e00b2631686d54eab84b91f0aca1", "08a4e2efec8a8e3312ca7460b9040bbf" },
+    { 192, "000000000000000000000000000000000000000000000000", "1b077a6af4b7f98229de786d7516b639", "275cfc0413d8ccb70513c3859b1d0f72" },
+    { 192, "000000000000000000000000000000000000000000000000", "9c2d8842e5f48f57648205d39a239af1", "c9b8135ff1b5adc413dfd053b21bd96d" },
+    { 192, "000000000000000000000000000000000000000000000000", "bff52510095f518ecca60af4205444bb", "4a3650c3371ce2eb35e389a171427440" },
+    { 192, "000000000000000000000000000000000000000000000000", "51719783d3185a535bd75adc65071ce1", "4f354592ff7c8847d2d0870ca9481b7c" },
+    { 192, "000000000000000000000000000000000000000000000000", "26aa49dcfe7629a8901a69a9914e6dfd", "d5e08bf9a182e857cf40b3a36ee248cc" },
+    { 192, "000000000000000000000000000000000000000000000000", "941a4773058224e1ef66d10e0a6ee782", "067cd9d3749207791841562507fa9626" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "014730f80ac625fe84f026c60bfd547d", "5c9d844ed46f9885085e5d6a4f94c7d7" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "0b24af36193ce4665f2825d7b4749c98", "a9ff75bd7cf6613d3731c77c3b6d0c04" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "761c1fe41a18acf20d241650611d90f1", "623a52fcea5d443e48d9181ab32c7421" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "8a560769d605868ad80d819bdba03771", "38f2c7ae10612415d27ca190d27da8b4" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "91fbef2d15a97816060bee1feaa49afe", "1bc704f1bce135ceb810341b216d7abe" },
+
+    { 128, "10a58869d74be5a374cf867cfb473859", "00000000000000000000000000000000", "6d251e6944b051e04eaa6fb4dbf78465" },
+    { 128, "caea65cdbb75e9169ecd22ebe6e54675", "00000000000000000000000000000000", "6e29201190152df4ee058139def610bb" },
+    { 128, "a2e2fa9baf7d20822ca9f0542f764a41", "00000000000000000000000000000000", "c3b44b95d9d2f25670eee9a0de099fa3" },
+    { 128, "b6364ac4e1de1e285eaf144a2415f7a0", "00000000000000000000000000000000", "5d9b05578fc944b3cf1ccf0e746cd581" },
+    { 128, "64cf9c7abc50b888af65f49d521944b2", "00000000000000000000000000000000", "f7efc89d5dba578104016ce5ad659c05" },
+    { 128, "47d6742eefcc0465dc96355e851b64d9", "00000000000000000000000000000000", "0306194f666d183624aa230a8b264ae7" },
+    { 128, "3eb39790678c56bee34bbcdeccf6cdb5", "00000000000000000000000000000000", "858075d536d79ccee571f7d7204b1f67" },
+    { 128, "64110a924f0743d500ccadae72c13427", "00000000000000000000000000000000", "35870c6a57e9e92314bcb8087cde72ce" },
+    { 128, "18d8126516f8a12ab1a36d9f04d68e51", "00000000000000000000000000000000", "6c68e9be5ec41e22c825b7c7affb4363" },
+    { 128, "f530357968578480b398a3c251cd1093", "00000000000000000000000000000000", "f5df39990fc688f1b07224cc03e86cea" },
+    { 128, "da84367f325d42d601b4326964802e8e", "00000000000000000000000000000000", "bba071bcb470f8f6586e5d3add18bc66" },
+    { 128, "e37b1c6aa2846f6fdb413f238b089f23", "00000000000000000000000000000000", "43c9f7e62f5d288bb27aa40ef8fe1ea8" },
+    { 128, "6c002b682483e0cabcc731c253be5674", "00000000000000000000000000000000", "3580d19cff44f1014a7c966a69059de5" },
+    { 128, "143ae8ed6555aba96110ab58893a8ae1", "00000000000000000000000000000000", "806da864dd29d48deafbe764f8202aef" },
+    { 128, "b69418a85332240dc82492353956ae0c", "00000000000000000000000000000000", "a303d940ded8f0baff6f75414cac5243" },
+    { 128, "71b5c08a1993e1362e4d0ce9b22b78d5", "00000000000000000000000000000000", "c2dabd117f8a3ecabfbb11d12194d9d0" },
+    { 128, "e234cdca2606b81f29408d5f6da21206", "00000000000000000000000000000000", "fff60a4740086b3b9c56195b98d91a7b" },
+    { 128, "13237c49074a3da078dc1d828bb78c6f", "00000000000000000000000000000000", "8146a08e2357f0caa30ca8c94d1a0544" },
+    { 128, "3071a2a48fe6cbd04f1a129098e308f8", "00000000000000000000000000000000", "4b98e06d356deb07ebb824e5713f7be3" },
+    { 128, "90f42ec0f68385f2ffc5dfc03a654dce", "00000000000000000000000000000000", "7a20a53d460fc9ce0423a7a0764c6cf2" },
+    { 128, "febd9a24d8b65c1c787d50a4ed3619a9", "00000000000000000000000000000000", "f4a70d8af877f9b02b4c40df57d45b17" },
+    { 192, "e9f065d7c13573587f7875357dfbb16c53489f6a4bd0f7cd", "00000000000000000000000000000000", "0956259c9cd5cfd0181cca53380cde06" },
+    { 192, "15d20f6ebc7e649fd95b76b107e6daba967c8a9484797f29", "00000000000000000000000000000000", "8e4e18424e591a3d5b6f0876f16f8594" },
+    { 192, "a8a282ee31c03fae4f8e9b8930d5473c2ed695a347e88b7c", "00000000000000000000000000000000", "93f3270cfc877ef17e106ce938979cb0" },
+    { 192, "cd62376d5ebb414917f0c78f05266433dc9192a1ec943300", "00000000000000000000000000000000", "7f6c25ff41858561bb62f36492e93c29" },
+    { 192, "502a6ab36984af268bf423c7f509205207fc1552af4a91e5", "00000000000000000000000000000000", "8e06556dcbb00b809a025047cff2a940" },
+    { 192, "25a39dbfd8034f71a81f9ceb55026e4037f8f6aa30ab44ce", "00000000000000000000000000000000", "3608c344868e94555d23a120f8a5502d" },
+    { 192, "e08c15411774ec4a908b64eadc6ac4199c7cd453f3aaef53", "00000000000000000000000000000000", "77da2021935b840b7f5dcc39132da9e5" },
+    { 192, "3b375a1ff7e8d44409696e6326ec9dec86138e2ae010b980", "00000000000000000000000000000000", "3b7c24f825e3bf9873c9f14d39a0e6f4" },
+    { 192, "950bb9f22cc35be6fe79f52c320af93dec5bc9c0c2f9cd53", "00000000000000000000000000000000", "64ebf95686b353508c90ecd8b6134316" },
+    { 192, "7001c487cc3e572cfc92f4d0e697d982e8856fdcc957da40", "00000000000000000000000000000000", "ff558c5d27210b7929b73fc708eb4cf1" },
+    { 192, "f029ce61d4e5a405b41ead0a883cc6a737da2cf50a6c92ae", "00000000000000000000000000000000", "a2c3b2a818075490a7b4c14380f02702" },
+    { 192, "61257134a518a0d57d9d244d45f6498cbc32f2bafc522d79", "00000000000000000000000000000000", "cfe4d74002696ccf7d87b14a2f9cafc9" },
+    { 192, "b0ab0a6a818baef2d11fa33eac947284fb7d748cfb75e570", "00000000000000000000000000000000", "d2eafd86f63b109b91f5dbb3a3fb7e13" },
+    { 192, "ee053aa011c8b428cdcc3636313c54d6a03cac01c71579d6", "00000000000000000000000000000000", "9b9fdd1c5975655f539998b306a324af" },
+    { 192, "d2926527e0aa9f37b45e2ec2ade5853ef807576104c7ace3", "00000000000000000000000000000000", "dd619e1cf204446112e0af2b9afa8f8c" },
+    { 192, "982215f4e173dfa0fcffe5d3da41c4812c7bcc8ed3540f93", "00000000000000000000000000000000", "d4f0aae13c8fe9339fbf9e69ed0ad74d" },
+    { 192, "98c6b8e01e379fbd14e61af6af891596583565f2a27d59e9", "00000000000000000000000000000000", "19c80ec4a6deb7e5ed1033dda933498f" },
+    { 192, "b3ad5cea1dddc214ca969ac35f37dae1a9a9d1528f89bb35", "00000000000000000000000000000000", "3cf5e1d21a17956d1dffad6a7c41c659" },
+    { 192, "45899367c3132849763073c435a9288a766c8b9ec2308516", "00000000000000000000000000000000", "69fd12e8505f8ded2fdcb197a121b362" },
+    { 192, "ec250e04c3903f602647b85a401a1ae7ca2f02f67fa4253e", "00000000000000000000000000000000", "8aa584e2cc4d17417a97cb9a28ba29c8" },
+    { 192, "d077a03bd8a38973928ccafe4a9d2f455130bd0af5ae46a9", "00000000000000000000000000000000", "abc786fb1edb504580c4d882ef29a0c7" },
+    { 192, "d184c36cf0dddfec39e654195006022237871a47c33d3198", "00000000000000000000000000000000", "2e19fb60a3e1de0166f483c97824a978" },
+    { 192, "4c6994ffa9dcdc805b60c2c0095334c42d95a8fc0ca5b080", "00000000000000000000000000000000", "7656709538dd5fec41e0ce6a0f8e207d" },
+    { 192, "c88f5b00a4ef9a6840e2acaf33f00a3bdc4e25895303fa72", "00000000000000000000000000000000", "a67cf333b314d411d3c0ae6e1cfcd8f5" },
+    { 256, "c47b0294dbbbee0fec4757f22ffeee3587ca4730c3d33b691df38bab076bc558", "00000000000000000000000000000000", "46f2fb342d6f0ab477476fc501242c5f" },
+    { 256, "28d46cffa158533194214a91e712fc2b45b518076675affd910edeca5f41ac64", "00000000000000000000000000000000", "4bf3b0a69aeb6657794f2901b1440ad4" },
+    { 256, "c1cc358b449909a19436cfbb3f852ef8bcb5ed12ac7058325f56e6099aab1a1c", "00000000000000000000000000000000", "352065272169abf9856843927d0674fd" },
+    { 256, "984ca75f4ee8d706f46c2d98c0bf4a45f5b00d791c2dfeb191b5ed8e420fd627", "00000000000000000000000000000000", "4307456a9e67813b452e15fa8fffe398" },
+    { 256, "b43d08a447ac8609baadae4ff12918b9f68fc1653f1269222f123981ded7a92f", "00000000000000000000000000000000", "4663446607354989477a5c6f0f007ef4" },
+    { 256, "1d85a181b54cde51f0e098095b2962fdc93b51fe9b88602b3f54130bf76a5bd9", "00000000000000000000000000000000", "531c2c38344578b84d50b3c917bbb6e1" },
+    { 256, "dc0eba1f2232a7879ded34ed8428eeb8769b056bbaf8ad77cb65c3541430b4cf", "00000000000000000000000000000000", "fc6aec906323480005c58e7e1ab004ad" },
+    { 256, "f8be9ba615c5a952cabbca24f68f8593039624d524c816acda2c9183bd917cb9", "00000000000000000000000000000000", "a3944b95ca0b52043584ef02151926a8" },
+    { 256, "797f8b3d176dac5b7e34a2d539c4ef367a16f8635f6264737591c5c07bf57a3e", "00000000000000000000000000000000", "a74289fe73a4c123ca189ea1e1b49ad5" },
+    { 256, "6838d40caf927749c13f0329d331f448e202c73ef52c5f73a37ca635d4c47707", "00000000000000000000000000000000", "b91d4ea4488644b56cf0812fa7fcf5fc" },
+    { 256, "ccd1bc3c659cd3c59bc437484e3c5c724441da8d6e90ce556cd57d0752663bbc", "00000000000000000000000000000000", "304f81ab61a80c2e743b94d5002a126b" },
+    { 256, "13428b5e4c005e0636dd338405d173ab135dec2a25c22c5df0722d69dcc43887", "00000000000000000000000000000000", "649a71545378c783e368c9ade7114f6c" },
+    { 256, "07eb03a08d291d1b07408bf3512ab40c91097ac77461aad4bb859647f74f00ee", "00000000000000000000000000000000", "47cb030da2ab051dfc6c4bf6910d12bb" },
+    { 256, "90143ae20cd78c5d8ebdd6cb9dc1762427a96c78c639bccc41a61424564eafe1", "00000000000000000000000000000000", "798c7c005dee432b2c8ea5dfa381ecc3" },
+    { 256, "b7a5794d52737475d53d5a377200849be0260a67a2b22ced8bbef12882270d07", "00000000000000000000000000000000", "637c31dc2591a07636f646b72daabbe7" },
+    { 256, "fca02f3d5011cfc5c1e23165d413a049d4526a991827424d896fe3435e0bf68e", "00000000000000000000000000000000", "179a49c712154bbffbe6e7a84a18e220" }
+};
+
+// AESAVS VarTxt (zero key, plaintext with the first i + 1 bits set) and
+// VarKey (zero plaintext, key with the first i + 1 bits set) ciphertexts.
+static const char * varTxt128[128] = {
+    "3ad78e726c1ec02b7ebfe92b23d9ec34", "aae5939c8efdf2f04e60b9fe7117b2c2", "f031d4d74f5dcbf39daaf8ca3af6e527",
+    "96d9fd5cc4f07441727df0f33e401a36", "30ccdb044646d7e1f3ccea3dca08b8c0", "16ae4ce5042a67ee8e177b7c587ecc82",
+    "b6da0bb11a23855d9c5cb1b4c6412e0a", "db4f1aa530967d6732ce4715eb0ee24b", "a81738252621dd180a34f3455b4baa2f",
+    "77e2b508db7fd89234caf7939ee5621a", "b8499c251f8442ee13f0933b688fcd19", "965135f8a81f25c9d630b17502f68e53",
+    "8b87145a01ad1c6cede995ea3670454f", "8eae3b10a0c8ca6d1d3b0fa61e56b0b2", "64b4d629810fda6bafdf08f3b0d8d2c5",
+    "d7e5dbd3324595f8fdc7d7c571da6c2a", "f3f72375264e167fca9de2c1527d9606", "8ee79dd4f401ff9b7ea945d86666c13b",
+    "dd35cea2799940b40db3f819cb94c08b", "6941cb6b3e08c2b7afa581ebdd607b87", "2c20f439f6bb097b29b8bd6d99aad799",
+    "625d01f058e565f77ae86378bd2c49b3", "c0b5fd98190ef45fbb4301438d095950", "13001ff5d99806efd25da34f56be854b",
+    "3b594c60f5c8277a5113677f94208d82", "e9c0fc1818e4aa46bd2e39d638f89e05", "f8023ee9c3fdc45a019b4e985c7e1a54",
+    "35f40182ab4662f3023baec1ee796b57", "3aebbad7303649b4194a6945c6cc3694", "a2124bea53ec2834279bed7f7eb0f938",
+    "b9fb4399fa4facc7309e14ec98360b0a", "c26277437420c5d634f715aea81a9132", "171a0e1b2dd424f0e089af2c4c10f32f",
+    "7cadbe402d1b208fe735edce00aee7ce", "43b02ff929a1485af6f5c6d6558baa0f", "092faacc9bf43508bf8fa8613ca75dea",
+    "cb2bf8280f3f9742c7ed513fe802629c", "215a41ee442fa992a6e323986ded3f68", "f21e99cf4f0f77cea836e11a2fe75fb1",
+    "95e3a0ca9079e646331df8b4e70d2cd6", "4afe7f120ce7613f74fc12a01a828073", "827f000e75e2c8b9d479beed913fe678",
+    "35830c8e7aaefe2d30310ef381cbf691", "191aa0f2c8570144f38657ea4085ebe5", "85062c2c909f15d9269b6c18ce99c4f0",
+    "678034dc9e41b5a560ed239eeab1bc78", "c2f93a4ce5ab6d5d56f1b93cf19911c1", "1c3112bcb0c1dcc749d799743691bf82",
+    "00c55bd75c7f9c881989d3ec1911c0d4", "ea2e6b5ef182b7dff3629abd6a12045f", "22322327e01780b17397f24087f8cc6f",
+    "c9cacb5cd11692c373b2411768149ee7", "a18e3dbbca577860dab6b80da3139256", "79b61c37bf328ecca8d743265a3d425c",
+    "d2d99c6bcc1f06fda8e27e8ae3f1ccc7", "1bfd4b91c701fd6b61b7f997829d663b", "11005d52f25f16bdc9545a876a63490a",
+    "3a4d354f02bb5a5e47d39666867f246a", "d451b8d6e1e1a0ebb155fbbf6e7b7dc3", "6898d4f42fa7ba6a10ac05e87b9f2080",
+    "b611295e739ca7d9b50f8e4c0e754a3f", "7d33fc7d8abe3ca1936759f8f5deaf20", "3b5e0f566dc96c298f0c12637539b25c",
+    "f807c3e7985fe0f5a50e2cdb25c5109e", "41f992a856fb278b389a62f5d274d7e9", "10d3ed7a6fe15ab4d91acbc7d0767ab1",
+    "21feecd45b2e675973ac33bf0c5424fc", "1480cb3955ba62d09eea668f7c708817", "66404033d6b72b609354d5496e7eb511",
+    "1c317a220a7d700da2b1e075b00266e1", "ab3b89542233f1271bf8fd0c0f403545", "d93eae966fac46dca927d6b114fa3f9e",
+    "1bdec521316503d9d5ee65df3ea94ddf", "eef456431dea8b4acf83bdae3717f75f", "06f2519a2fafaa596bfef5cfa15c21b9",
+    "251a7eac7e2fe809e4aa8d0d7012531a", "3bffc16e4c49b268a20f8d96a60b4058", "e886f9281999c5bb3b3e8862e2f7c988",
+    "563bf90d61beef39f48dd625fcef1361", "4d37c850644563c69fd0acd9a049325b", "b87c921b91829ef3b13ca541ee1130a6",
+    "2e65eb6b6ea383e109accce8326b0393", "9ca547f7439edc3e255c0f4d49aa8990", "a5e652614c9300f37816b1f9fd0c87f9",
+    "14954f0b4697776f44494fe458d814ed", "7c8d9ab6c2761723fe42f8bb506cbcf7", "db7e1932679fdd99742aab04aa0d5a80",
+    "4c6a1c83e568cd10f27c2d73ded19c28", "90ecbe6177e674c98de412413f7ac915", "90684a2ac55fe1ec2b8ebd5622520b73",
+    "7472f9a7988607ca79707795991035e6", "56aff089878bf3352f8df172a3ae47d8", "65c0526cbe40161b8019a2a3171abd23",
+    "377be0be33b4e3e310b4aabda173f84f", "9402e9aa6f69de6504da8d20c4fcaa2f", "123c1f4af313ad8c2ce648b2e71fb6e1",
+    "1ffc626d30203dcdb0019fb80f726cf4", "76da1fbe3a50728c50fd2e621b5ad885", "082eb8be35f442fb52668e16a591d1d6",
+    "e656f9ecf5fe27ec3e4a73d00c282fb3", "2ca8209d63274cd9a29bb74bcd77683a", "79bf5dce14bb7dd73a8e3611de7ce026",
+    "3c849939a5d29399f344c4a0eca8a576", "ed3c0a94d59bece98835da7aa4f07ca2", "63919ed4ce10196438b6ad09d99cd795",
+    "7678f3a833f19fea95f3c6029e2bc610", "3aa426831067d36b92be7c5f81c13c56", "9272e2d2cdd11050998c845077a30ea0",
+    "088c4b53f5ec0ff814c19adae7f6246c", "4010a5e401fdf0a0354ddbcc0d012b17", "a87a385736c0a6189bd6589bd8445a93",
+    "545f2b83d9616dccf60fa9830e9cd287", "4b706f7f92406352394037a6d4f4688d", "b7972b3941c44b90afa7b264bfba7387",
+    "6f45732cf10881546f0fd23896d2bb60", "2e3579ca15af27f64b3c955a5bfc30ba", "34a2c5a91ae2aec99b7d1b5fa6780447",
+    "a4d6616bd04f87335b0e53351227a9ee", "7f692b03945867d16179a8cefc83ea3f", "3bd141ee84a0e6414a26e7a4f281f8a2",
+    "d1788f572d98b2b16ec5d5f3922b99bc", "0833ff6f61d98a57b288e8c3586b85a6", "8568261797de176bf0b43becc6285afb",
+    "f9b0fda0c4a898f5b9e6f661c4ce4d07", "8ade895913685c67c5269f8aae42983e", "39bde67d5c8ed8a8b1c37eb8fa9f5ac0",
+    "5c005e72c1418c44f569f2ea33ba54f3", "3f5b8cc9ea855a0afa7347d23e8d664e"
+};
+
+static const char * varKey128[128] = {
+    "0edd33d3c621e546455bd8ba1418bec8", "4bc3f883450c113c64ca42e1112a9e87", "72a1da770f5d7ac4c9ef94d822affd97",
+    "970014d634e2b7650777e8e84d03ccd8", "f17e79aed0db7e279e955b5f493875a7", "9ed5a75136a940d0963da379db4af26a",
+    "c4295f83465c7755e8fa364bac6a7ea5", "b1d758256b28fd850ad4944208cf1155", "42ffb34c743de4d88ca38011c990890b",
+    "9958f0ecea8b2172c0c1995f9182c0f3", "956d7798fac20f82a8823f984d06f7f5", "a01bf44f2d16be928ca44aaf7b9b106b",
+    "b5f1a33e50d40d103764c76bd4c6b6f8", "2637050c9fc0d4817e2d69de878aee8d", "113ecbe4a453269a0dd26069467fb5b5",
+    "97d0754fe68f11b9e375d070a608c884", "c6a0b3e998d05068a5399778405200b4", "df556a33438db87bc41b1752c55e5e49",
+    "90fb128d3a1af6e548521bb962bf1f05", "26298e9c1db517c215fadfb7d2a8d691", "a6cb761d61f8292d0df393a279ad0380",
+    "12acd89b13cd5f8726e34d44fd486108", "95b1703fc57ba09fe0c3580febdd7ed4", "de11722d893e9f9121c381becc1da59a",
+    "6d114ccb27bf391012e8974c546d9bf2", "5ce37e17eb4646ecfac29b9cc38d9340", "18c1b6e2157122056d0243d8a165cddb",
+    "99693e6a59d1366c74d823562d7e1431", "6c7c64dc84a8bba758ed17eb025a57e3", "e17bc79f30eaab2fac2cbbe3458d687a",
+    "1114bc2028009b923f0b01915ce5e7c4", "9c28524a16a1e1c1452971caa8d13476", "ed62e16363638360fdd6ad62112794f0",
+    "5a8688f0b2a2c16224c161658ffd4044", "23f710842b9bb9c32f26648c786807ca", "44a98bf11e163f632c47ec6a49683a89",
+    "0f18aff94274696d9b61848bd50ac5e5", "82408571c3e2424540207f833b6dda69", "303ff996947f0c7d1f43c8f3027b9b75",
+    "7df4daf4ad29a3615a9b6ece5c99518a", "c72954a48d0774db0b4971c526260415", "1df9b76112dc6531e07d2cfda04411f0",
+    "8e4d8e699119e1fc87545a647fb1d34f", "e6c4807ae11f36f091c57d9fb68548d1", "8ebf73aad49c82007f77a5c1ccec6ab4",
+    "4fb288cc2040049001d2c7585ad123fc", "04497110efb9dceb13e2b13fb4465564", "75550e6cb5a88e49634c9ab69eda0430",
+    "b6768473ce9843ea66a81405dd50b345", "cb2f430383f9084e03a653571e065de6", "ff4e66c07bae3e79fb7d210847a3b0ba",
+    "7b90785125505fad59b13c186dd66ce3", "8b527a6aebdaec9eaef8eda2cb7783e5", "43fdaf53ebbc9880c228617d6a9b548b",
+    "53786104b9744b98f052c46f1c850d0b", "b5ab3013dd1e61df06cbaf34ca2aee78", "7470469be9723030fdcc73a8cd4fbb10",
+    "a35a63f5343ebe9ef8167bcb48ad122e", "fd8687f0757a210e9fdf181204c30863", "7a181e84bd5457d26a88fbae96018fb0",
+    "653317b9362b6f9b9e1a580e68d494b5", "995c9dc0b689f03c45867b5faa5c18d1", "77a4d96d56dda398b9aabecfc75729fd",
+    "84be19e053635f09f2665e7bae85b42d", "32cd652842926aea4aa6137bb2be2b5e", "493d4a4f38ebb337d10aa84e9171a554",
+    "d9bff7ff454b0ec5a4a2a69566e2cb84", "3535d565ace3f31eb249ba2cc6765d7a", "f60e91fc3269eecf3231c6e9945697c6",
+    "ab69cfadf51f8e604d9cc37182f6635a", "7866373f24a0b6ed56e0d96fcdafb877", "1ea448c2aac954f5d812e9d78494446a",
+    "acc5599dd8ac02239a0fef4a36dd1668", "d8764468bb103828cf7e1473ce895073", "1b0d02893683b9f180458e4aa6b73982",
+    "96d9b017d302df410a937dcdb8bb6e43", "ef1623cc44313cff440b1594a7e21cc6", "284ca2fa35807b8b0ae4d19e11d7dbd7",
+    "f2e976875755f9401d54f36e2a23a594", "ec198a18e10e532403b7e20887c8dd80", "545d50ebd919e4a6949d96ad47e46a80",
+    "dbdfb527060e0a71009c7bb0c68f1d44", "9cfa1322ea33da2173a024f2ff0d896d", "8785b1a75b0f3bd958dcd0e29318c521",
+    "38f67b9e98e4a97b6df030a9fcdd0104", "192afffb2c880e82b05926d0fc6c448b", "6a7980ce7b105cf530952d74daaf798c",
+    "ea3695e1351b9d6858bd958cf513ef6c", "6da0490ba0ba0343b935681d2cce5ba1", "f0ea23af08534011c60009ab29ada2f1",
+    "ff13806cf19cc38721554d7c0fcdcd4b", "6838af1f4f69bae9d85dd188dcdf0688", "36cf44c92d550bfb1ed28ef583ddf5d7",
+    "d06e3195b5376f109d5c4ec6c5d62ced", "c440de014d3d610707279b13242a5c36", "f0c5c6ffa5e0bd3a94c88f6b6f7c16b9",
+    "3e40c3901cd7effc22bffc35dee0b4d9", "b63305c72bedfab97382c406d0c49bc6", "36bbaab22a6bd4925a99a2b408d2dbae",
+    "307c5b8fcd0533ab98bc51e27a6ce461", "829c04ff4c07513c0b3ef05c03e337b5", "f17af0e895dda5eb98efc68066e84c54",
+    "277167f3812afff1ffacb4a934379fc3", "2cb1dc3a9c72972e425ae2ef3eb597cd", "36aeaa3a213e968d4b5b679d3a2c97fe",
+    "9241daca4fdd034a82372db50e1a0f3f", "c14574d9cd00cf2b5a7f77e53cd57885", "793de39236570aba83ab9b737cb521c9",
+    "16591c0f27d60e29b85a96c33861a7ef", "44fb5c4d4f5cb79be5c174a3b1c97348", "674d2b61633d162be59dde04222f4740",
+    "b4750ff263a65e1f9e924ccfd98f3e37", "62d0662d6eaeddedebae7f7ea3a4f6b6", "70c46bb30692be657f7eaa93ebad9897",
+    "323994cfb9da285a5d9642e1759b224a", "1dbf57877b7b17385c85d0b54851e371", "dfa5c097cdc1532ac071d57b1d28d1bd",
+    "3a0c53fa37311fc10bd2a9981f513174", "ba4f970c0a25c41814bdae2e506be3b4", "2dce3acb727cd13ccd76d425ea56e4f6",
+    "5160474d504b9b3eefb68d35f245f4b3", "41a8a947766635dec37553d9a6c0cbb7", "25d6cfe6881f2bf497dd14cd4ddf445b",
+    "41c78c135ed9e98c096640647265da1e", "5a4d404d8917e353e92a21072c3b2305", "02bc96846b3fdc71643f384cd3cc3eaf",
+    "9ba4a9143f4e5d4048521c4f8877d88e", "a1f6258c877d5fcd8964484538bfc92c"
+};
+
+static const char * varTxt192[128] = {
+    "6cd02513e8d4dc986b4afe087a60bd0c", "2ce1f8b7e30627c1c4519eada44bc436", "9946b5f87af446f5796c1fee63a2da24",
+    "2a560364ce529efc21788779568d5555", "35c1471837af446153bce55d5ba72a0a", "ce60bc52386234f158f84341e534cd9e",
+    "8c7c27ff32bcf8dc2dc57c90c2903961", "32bb6a7ec84499e166f936003d55a5bb", "a5c772e5c62631ef660ee1d5877f6d1b",
+    "030d7e5b64f380a7e4ea5387b5cd7f49", "0dc9a2610037009b698f11bb7e86c83e", "0046612c766d1840c226364f1fa7ed72",
+    "4880c7e08f27befe78590743c05e698b", "2520ce829a26577f0f4822c4ecc87401", "8765e8acc169758319cb46dc7bcf3dca",
+    "e98f4ba4f073df4baa116d011dc24a28", "f378f68c5dbf59e211b3a659a7317d94", "283d3b069d8eb9fb432d74b96ca762b4",
+    "a7e1842e8a87861c221a500883245c51", "77aa270471881be070fb52c7067ce732", "01b0f476d484f43f1aeb6efa9361a8ac",
+    "1c3a94f1c052c55c2d8359aff2163b4f", "e8a067b604d5373d8b0f2e05a03b341b", "a7876ec87f5a09bfea42c77da30fd50e",
+    "0cf3e9d3a42be5b854ca65b13f35f48d", "6c62f6bbcab7c3e821c9290f08892dda", "7f5e05bd2068738196fee79ace7e3aec",
+    "440e0d733255cda92fb46e842fe58054", "aa5d5b1c4ea1b7a22e5583ac2e9ed8a7", "77e537e89e8491e8662aae3bc809421d",
+    "997dd3e9f1598bfa73f75973f7e93b76", "1b38d4f7452afefcb7fc721244e4b72e", "0be2b18252e774dda30cdda02c6906e3",
+    "d2695e59c20361d82652d7d58b6f11b2", "902d88d13eae52089abd6143cfe394e9", "d49bceb3b823fedd602c305345734bd2",
+    "707b1dbb0ffa40ef7d95def421233fae", "7ca0c1d93356d9eb8aa952084d75f913", "f2cbf9cb186e270dd7bdb0c28febc57d",
+    "c94337c37c4e790ab45780bd9c3674a0", "8e3558c135252fb9c9f367ed609467a1", "1b72eeaee4899b443914e5b3a57fba92",
+    "011865f91bc56868d051e52c9efd59b7", "e4771318ad7a63dd680f6e583b7747ea", "61e3d194088dc8d97e9e6db37457eac5",
+    "36ff1ec9ccfbc349e5d356d063693ad6", "3cc9e9a9be8cc3f6fb2ea24088e9bb19", "1ee5ab003dc8722e74905d9a8fe3d350",
+    "245339319584b0a412412869d6c2eada", "7bd496918115d14ed5380852716c8814", "273ab2f2b4a366a57d582a339313c8b1",
+    "113365a9ffbe3b0ca61e98507554168b", "afa99c997ac478a0dea4119c9e45f8b1", "9216309a7842430b83ffb98638011512",
+    "62abc792288258492a7cb45145f4b759", "534923c169d504d7519c15d30e756c50", "fa75e05bcdc7e00c273fa33f6ee441d2",
+    "7d350fa6057080f1086a56b17ec240db", "f34e4a6324ea4a5c39a661c8fe5ada8f", "0882a16f44088d42447a29ac090ec17e",
+    "3a3c15bfc11a9537c130687004e136ee", "22c0a7678dc6d8cf5c8a6d5a9960767c", "b46b09809d68b9a456432a79bdc2e38c",
+    "93baaffb35fbe739c17c6ac22eecf18f", "c8aa80a7850675bc007c46df06b49868", "12c6f3877af421a918a84b775858021d",
+    "33f123282c5d633924f7d5ba3f3cab11", "a8f161002733e93ca4527d22c1a0c5bb", "b72f70ebf3e3fda23f508eec76b42c02",
+    "6a9d965e6274143f25afdcfc88ffd77c", "a0c74fd0b9361764ce91c5200b095357", "091d1fdc2bd2c346cd5046a8c6209146",
+    "e2a37580116cfb71856254496ab0aca8", "e0b3a00785917c7efc9adba322813571", "733d41f4727b5ef0df4af4cf3cffa0cb",
+    "a99ebb030260826f981ad3e64490aa4f", "73f34c7d3eae5e80082c1647524308ee", "40ebd5ad082345b7a2097ccd3464da02",
+    "7cc4ae9a424b2cec90c97153c2457ec5", "54d632d03aba0bd0f91877ebdd4d09cb", "d3427be7e4d27cd54f5fe37b03cf0897",
+    "b2099795e88cc158fd75ea133d7e7fbe", "a6cae46fb6fadfe7a2c302a34242817b", "026a7024d6a902e0b3ffccbaa910cc3f",
+    "156f07767a85a4312321f63968338a01", "15eec9ebf42b9ca76897d2cd6c5a12e2", "db0d3a6fdcc13f915e2b302ceeb70fd8",
+    "71dbf37e87a2e34d15b20e8f10e48924", "c745c451e96ff3c045e4367c833e3b54", "340da09c2dd11c3b679d08ccd27dd595",
+    "8279f7c0c2a03ee660c6d392db025d18", "a4b2c7d8eba531ff47c5041a55fbd1ec", "74569a2ca5a7bd5131ce8dc7cbfbf72f",
+    "3713da0c0219b63454035613b5a403dd", "8827551ddcc9df23fa72a3de4e9f0b07", "2e3febfd625bfcd0a2c06eb460da1732",
+    "ee82e6ba488156f76496311da6941deb", "4770446f01d1f391256e85a1b30d89d3", "af04b68f104f21ef2afb4767cf74143c",
+    "cf3579a9ba38c8e43653173e14f3a4c6", "b3bba904f4953e09b54800af2f62e7d4", "fc4249656e14b29eb9c44829b4c59a46",
+    "9b31568febe81cfc2e65af1c86d1a308", "9ca09c25f273a766db98a480ce8dfedc", "b909925786f34c3c92d971883c9fbedf",
+    "82647f1332fe570a9d4d92b2ee771d3b", "3604a7e80832b3a99954bca6f5b9f501", "884607b128c5de3ab39a529a1ef51bef",
+    "670cfa093d1dbdb2317041404102435e", "7a867195f3ce8769cbd336502fbb5130", "52efcf64c72b2f7ca5b3c836b1078c15",
+    "4019250f6eefb2ac5ccbcae044e75c7e", "022c4f6f5a017d292785627667ddef24", "e9c21078a2eb7e03250f71000fa9e3ed",
+    "a13eaeeb9cd391da4e2b09490b3e7fad", "c958a171dca1d4ed53e1af1d380803a9", "21442e07a110667f2583eaeeee44dc8c",
+    "59bbb353cf1dd867a6e33737af655e99", "43cd3b25375d0ce41087ff9fe2829639", "6b98b17e80d1118e3516bd768b285a84",
+    "ae47ed3676ca0c08deea02d95b81db58", "34ec40dc20413795ed53628ea748720b", "4dc68163f8e9835473253542c8a65d46",
+    "2aabb999f43693175af65c6c612c46fb", "e01f94499dac3547515c5b1d756f0f58", "9d12435a46480ce00ea349f71799df9a",
+    "cef41d16d266bdfe46938ad7884cc0cf", "b13db4da1f718bc6904797c82bcf2d32"
+};
+
+static const char * varKey192[192] = {
+    "de885dc87f5a92594082d02cc1e1b42c", "132b074e80f2a597bf5febd8ea5da55e", "6eccedf8de592c22fb81347b79f2db1f",
+    "180b09f267c45145db2f826c2582d35c", "edd807ef7652d7eb0e13c8b5e15b3bc0", "9978bcf8dd8fd72241223ad24b31b8a4",
+    "5310f654343e8f27e12c83a48d24ff81", "833f71258d53036b02952c76c744f5a1", "eba83ff200cff9318a92f8691a06b09f",
+    "ff620ccbe9f3292abdf2176b09f04eba", "7ababc4b3f516c9aafb35f4140b548f9", "aa187824d9c4582b0916493ecbde8c57",
+    "1c0ad553177fd5ea1092c9d626a29dc4", "a5dc46c37261194124ecaebd680408ec", "e4f2f2ae23e9b10bacfa58601531ba54",
+    "b7d67cf1a1e91e8ff3a57a172c7bf412", "26706be06967884e847d137128ce47b3", "b2f8b409b0585909aad3a7b5a219072a",
+    "5e4b7bff0290c78344c54a23b722cd20", "07093657552d4414227ce161e9ebf7dd", "e1af1e7d8bc225ed4dffb771ecbb9e67",
+    "ef6555253635d8432156cfd9c11b145a", "fb4035074a5d4260c90cbd6da6c3fceb", "446ee416f9ad1c103eb0cc96751c88e1",
+    "198ae2a4637ac0a7890a8fd1485445c9", "562012ec8faded0825fb2fa70ab30cbd", "cc8a64b46b5d88bf7f247d4dbaf38f05",
+    "a168253762e2cc81b42d1e5001762699", "1b41f83b38ce5032c6cd7af98cf62061", "61a89990cd1411750d5fb0dc988447d4",
+    "b5accc8ed629edf8c68a539183b1ea82", "b16fa71f846b81a13f361c43a851f290", "4fad6efdff5975aee7692234bcd54488",
+    "ebfdb05a783d03082dfe5fdd80a00b17", "eb81b584766997af6ba5529d3bdd8609", "0cf4ff4f49c8a0ca060c443499e29313",
+    "cc4ba8a8e029f8b26d8afff9df133bb6", "fefebf64360f38e4e63558f0ffc550c3", "12ad98cbf725137d6a8108c2bed99322",
+    "6afaa996226198b3e2610413ce1b3f78", "2a8ce6747a7e39367828e290848502d9", "223736e8b8f89ca1e37b6deab40facf1",
+    "c0f797e50418b95fa6013333917a9480", "a758de37c2ece2a02c73c01fedc9a132", "3a9b87ae77bae706803966c66c73adbd",
+    "d365ab8df8ffd782e358121a4a4fc541", "c8dcd9e6f75e6c36c8daee0466f0ed74", "c79a637beb1c0304f14014c037e736dd",
+    "105f0a25e84ac930d996281a5f954dd9", "42e4074b2927973e8d17ffa92f7fe615", "4fe2a9d2c1824449c69e3e0398f12963",
+    "b7f29c1e1f62847a15253b28a1e9d712", "36ed5d29b903f31e8983ef8b0a2bf990", "27b8070270810f9d023f9dd7ff3b4aa2",
+    "94d46e155c1228f61d1a0db4815ecc4b", "ca6108d1d98071428eeceef1714b96dd", "dc5b25b71b6296cf73dd2cdcac2f70b1",
+    "44aba95e8a06a2d9d3530d2677878c80", "a570d20e89b467e8f5176061b81dd396", "758f4467a5d8f1e7307dc30b34e404f4",
+    "bcea28e9071b5a2302970ff352451bc5", "7523c00bc177d331ad312e09c9015c1c", "ccac61e3183747b3f5836da21a1bc4f4",
+    "707b075791878880b44189d3522b8c30", "7132d0c0e4a07593cf12ebb12be7688c", "effbac1644deb0c784275fe56e19ead3",
+    "a005063f30f4228b374e2459738f26bb", "29975b5f48bb68fcbbc7cea93b452ed7", "cf3f2576e2afedc74bb1ca7eeec1c0e7",
+    "07c403f5f966e0e3d9f296d6226dca28", "c8c20908249ab4a34d6dd0a31327ff1a", "c0541329ecb6159ab23b7fc5e6a21bca",
+    "7aa1acf1a2ed9ba72bc6deb31d88b863", "808bd8eddabb6f3bf0d5a8a27be1fe8a", "273c7d7685e14ec66bbb96b8f05b6ddd",
+    "32752eefc8c2a93f91b6e73eb07cca6e", "d893e7d62f6ce502c64f75e281f9c000", "8dfd999be5d0cfa35732c0ddc88ff5a5",
+    "02647c76a300c3173b841487eb2bae9f", "172df8b02f04b53adab028b4e01acd87", "054b3bf4998aeb05afd87ec536533a36",
+    "3783f7bf44c97f065258a666cae03020", "aad4c8a63f80954104de7b92cede1be1", "cbfe61810fd5467ccdacb75800f3ac07",
+    "830d8a2590f7d8e1b55a737f4af45f34", "fffcd4683f858058e74314671d43fa2c", "523d0babbb82f46ebc9e70b1cd41ddd0",
+    "344aab37080d7486f7d542a309e53eed", "56c5609d0906b23ab9caca816f5dbebd", "7026026eedd91adc6d831cdf9894bdc6",
+    "88330baa4f2b618fc9d9b021bf503d5a", "fc9e0ea22480b0bac935c8a8ebefcdcf", "29ca779f398fb04f867da7e8a44756cb",
+    "51f89c42985786bfc43c6df8ada36832", "6ac1de5fb8f21d874e91c53b560c50e3", "03aa9058490eda306001a8a9f48d0ca7",
+    "e34ec71d6128d4871865d617c30b37e3", "14be1c535b17cabd0c4d93529d69bf47", "c9ef67756507beec9dd3862883478044",
+    "40e231fa5a5948ce2134e92fc0664d4b", "03194b8e5dda5530d0c678c0b48f5d92", "90bd086f237cc4fd99f4d76bde6b4826",
+    "19259761ca17130d6ed86d57cd7951ee", "d7cbb3f34b9b450f24b0e8518e54da6d", "725b9caebe9f7f417f4068d0d2ee20b3",
+    "9d924b934a90ce1fd39b8a9794f82672", "c50562bf094526a91c5bc63c0c224995", "d2f11805046743bd74f57188d9188df7",
+    "8dd274bd0f1b58ae345d9e7233f9b8f3", "9d6bdc8f4ce5feb0f3bed2e4b9a9bb0b", "fd5548bcf3f42565f7efa94562528d46",
+    "d2ccaebd3a4c3e80b063748131ba4a71", "e03cb23d9e11c9d93f117e9c0a91b576", "78f933a2081ac1db84f69d10f4523fe0",
+    "4061f7412ed320de0edc8851c2e2436f", "9064ba1cd04ce6bab98474330814b4d4", "48391bffb9cfff80ac238c886ef0a461",
+    "b8d2a67df5a999fdbf93edd0343296c9", "aaca7367396b69a221bd632bea386eec", "a80fd5020dfe65f5f16293ec92c6fd89",
+    "2162995b8217a67f1abc342e146406f8", "c6a6164b7a60bae4e986ffac28dfadd9", "64e0d7f900e3d9c83e4b8f96717b2146",
+    "1ad2561de8c1232f5d8dbab4739b6cbb", "279689e9a557f58b1c3bf40c97a90964", "c4637e4a5e6377f9cc5a8638045de029",
+    "492e607e5aea4688594b45f3aee3df90", "e8c4e4381feec74054954c05b777a00a", "91549514605f38246c9b724ad839f01d",
+    "74b24e3b6fefe40a4f9ef7ac6e44d76a", "2437a683dc5d4b52abb4a123a8df86c6", "bb2852c891c5947d2ed44032c421b85f",
+    "1b9f5fbd5e8a4264c0a85b80409afa5e", "30dab809f85a917fe924733f424ac589", "eaef5c1f8d605192646695ceadc65f32",
+    "b8aa90040b4c15a12316b78e0f9586fc", "97fac8297ceaabc87d454350601e0673", "9b47ef567ac28dfe488492f157e2b2e0",
+    "1b8426027ddb962b5c5ba7eb8bc9ab63", "e917fc77e71992a12dbe4c18068bec82", "dceebbc98840f8ae6daf76573b7e56f4",
+    "4e11a9f74205125b61e0aee047eca20d", "f60467f55a1f17eab88e800120cbc284", "d436649f600b449ee276530f0cd83c11",
+    "3bc0e3656a9e3ac7cd378a737f53b637", "6bacae63d33b928aa8380f8d54d88c17", "8935ffbc75ae6251bf8e859f085adcb9",
+    "93dc4970fe35f67747cb0562c06d875a", "14f9df858975851797ba604fb0d16cc7", "02ea0c98dca10b38c21b3b14e8d1b71f",
+    "8f091b1b5b0749b2adc803e63dda9b72", "05b389e3322c6da08384345a4137fd08", "381308c438f35b399f10ad71b05027d8",
+    "68c230fcfa9279c3409fc423e2acbe04", "1c84a475acb011f3f59f4f46b76274c0", "45119b68cb3f8399ee60066b5611a4d7",
+    "9423762f527a4060ffca312dcca22a16", "f361a2745a33f056a5ac6ace2f08e344", "5ef145766eca849f5d011536a6557fdb",
+    "c9af27b2c89c9b4cf4a0c4106ac80318", "fb9c4f16c621f4eab7e9ac1d7551dd57", "138e06fba466fa70854d8c2e524cffb2",
+    "fb4bc78b225070773f04c40466d4e90c", "8b2cbff1ed0150feda8a4799be94551f", "08b30d7b3f27962709a36bcadfb974bd",
+    "fdf6d32e044d77adcf37fb97ac213326", "93cb284ecdcfd781a8afe32077949e88", "7b017bb02ec87b2b94c96e40a26fc71a",
+    "c5c038b6990664ab08a3aaa5df9f3266", "4b7020be37fab6259b2a27f4ec551576", "60136703374f64e860b48ce31f930716",
+    "8d63a269b14d506ccc401ab8a9f1b591", "d317f81dc6aa454aee4bd4a5a5cff4bd", "dddececd5354f04d530d76ed884246eb",
+    "41c5205cc8fd8eda9a3cffd2518f365a", "cf42fb474293d96eca9db1b37b1ba676", "a231692607169b4ecdead5cd3b10db3e",
+    "ace4b91c9c669e77e7acacd19859ed49", "75db7cfd4a7b2b62ab78a48f3ddaf4af", "c1faba2d46e259cf480d7c38e4572a58",
+    "241c45bc6ae16dee6eb7bea128701582", "8fd03057cf1364420c2b78069a3e2502", "ddb505e6cc1384cbaec1df90b80beb20",
+    "5674a3bed27bf4bd3622f9f5fe208306", "b687f26a89cfbfbb8e5eeac54055315e", "0547dd32d3b29ab6a4caeb606c5b6f78",
+    "186861f8bc5386d31fb77f720c3226e6", "eacf1e6c4224efb38900b185ab1dfd42", "d241aab05a42d319de81d874f5c7b90d",
+    "5eb9bc759e2ad8d2140a6c762ae9e1ab", "018596e15e78e2c064159defce5f3085", "dd8a493514231cbf56eccee4c40889fb"
+};
+
+static const char * varTxt256[128] = {
+    "ddc6bf790c15760d8d9aeb6f9a75fd4e", "0a6bdc6d4c1e6280301fd8e97ddbe601", "9b80eefb7ebe2d2b16247aa0efc72f5d",
+    "7f2c5ece07a98d8bee13c51177395ff7", "7818d800dcf6f4be1e0e94f403d1e4c2", "e74cd1c92f0919c35a0324123d6177d3",
+    "8092a4dcf2da7e77e93bdd371dfed82e", "49af6b372135acef10132e548f217b17", "8bcd40f94ebb63b9f7909676e667f1e7",
+    "fe1cffb83f45dcfb38b29be438dbd3ab", "0dc58a8d886623705aec15cb1e70dc0e", "c218faa16056bd0774c3e8d79c35a5e4",
+    "047bba83f7aa841731504e012208fc9e", "dc8f0e4915fd81ba70a331310882f6da", "1569859ea6b7206c30bf4fd0cbfac33c",
+    "300ade92f88f48fa2df730ec16ef44cd", "1fe6cc3c05965dc08eb0590c95ac71d0", "59e858eaaa97fec38111275b6cf5abc0",
+    "2239455e7afe3b0616100288cc5a723b", "3ee500c5c8d63479717163e55c5c4522", "d5e38bf15f16d90e3e214041d774daa8",
+    "b1f4066e6f4f187dfe5f2ad1b17819d0", "6ef4cc4de49b11065d7af2909854794a", "ac86bc606b6640c309e782f232bf367f",
+    "36aff0ef7bf3280772cf4cac80a0d2b2", "1f8eedea0f62a1406d58cfc3ecea72cf", "abf4154a3375a1d3e6b1d454438f95a6",
+    "96f96e9d607f6615fc192061ee648b07", "cf37cdaaa0d2d536c71857634c792064", "fbd6640c80245c2b805373f130703127",
+    "8d6a8afe55a6e481badae0d146f436db", "6a4981f2915e3e68af6c22385dd06756", "42a1136e5f8d8d21d3101998642d573b",
+    "9b471596dc69ae1586cee6158b0b0181", "753665c4af1eff33aa8b628bf8741cfd", "9a682acf40be01f5b2a4193c9a82404d",
+    "54fafe26e4287f17d1935f87eb9ade01", "49d541b2e74cfe73e6a8e8225f7bd449", "11a45530f624ff6f76a1b3826626ff7b",
+    "f96b0c4a8bc6c86130289f60b43b8fba", "48c7d0e80834ebdc35b6735f76b46c8b", "2463531ab54d66955e73edc4cb8eaa45",
+    "ac9bd8e2530469134b9d5b065d4f565b", "3f5f9106d0e52f973d4890e6f37e8a00", "20ebc86f1304d272e2e207e59db639f0",
+    "e67ae6426bf9526c972cff072b52252c", "1a518dddaf9efa0d002cc58d107edfc8", "ead731af4d3a2fe3b34bed047942a49f",
+    "b1d4efe40242f83e93b6c8d7efb5eae9", "cd2b1fec11fd906c5c7630099443610a", "a1853fe47fe29289d153161d06387d21",
+    "4632154179a555c17ea604d0889fab14", "dd27cac6401a022e8f38f9f93e774417", "c090313eb98674f35f3123385fb95d4d",
+    "cc3526262b92f02edce548f716b9f45c", "c0838d1a2b16a7c7f0dfcc433c399c33", "0d9ac756eb297695eed4d382eb126d26",
+    "56ede9dda3f6f141bff1757fa689c3e1", "768f520efe0f23e61d3ec8ad9ce91774", "b1144ddfa75755213390e7c596660490",
+    "1d7c0c4040b355b9d107a99325e3b050", "d8e2bb1ae8ee3dcf5bf7d6c38da82a1a", "faf82d178af25a9886a47e7f789b98d7",
+    "9b58dbfd77fe5aca9cfc190cd1b82d19", "77f392089042e478ac16c0c86a0b5db5", "19f08e3420ee69b477ca1420281c4782",
+    "a1b19beee4e117139f74b3c53fdcb875", "a37a5869b218a9f3a0868d19aea0ad6a", "bc3594e865bcd0261b13202731f33580",
+    "811441ce1d309eee7185e8c752c07557", "959971ce4134190563518e700b9874d1", "76b5614a042707c98e2132e2e805fe63",
+    "7d9fa6a57530d0f036fec31c230b0cc6", "964153a83bf6989a4ba80daa91c3e081", "a013014d4ce8054cf2591d06f6f2f176",
+    "d1c5f6399bf382502e385eee1474a869", "0007e20b8298ec354f0f5fe7470f36bd", "b95ba05b332da61ef63a2b31fcad9879",
+    "4620a49bd967491561669ab25dce45f4", "12e71214ae8e04f0bb63d7425c6f14d5", "4cc42fc1407b008fe350907c092e80ac",
+    "08b244ce7cbc8ee97fbba808cb146fda", "39b333e8694f21546ad1edd9d87ed95b", "3b271f8ab2e6e4a20ba8090f43ba78f3",
+    "9ad983f3bf651cd0393f0a73cccdea50", "8f476cbff75c1f725ce18e4bbcd19b32", "905b6267f1d6ab5320835a133f096f2a",
+    "145b60d6d0193c23f4221848a892d61a", "55cfb3fb6d75cad0445bbc8dafa25b0f", "7b8e7098e357ef71237d46d8b075b0f5",
+    "2bf27229901eb40f2df9d8398d1505ae", "83a63402a77f9ad5c1e931a931ecd706", "6f8ba6521152d31f2bada1843e26b973",
+    "e5c3b8e30fd2d8e6239b17b44bd23bbd", "1ac1f7102c59933e8b2ddc3f14e94baa", "21d9ba49f276b45f11af8fc71a088e3d",
+    "649f1cddc3792b4638635a392bc9bade", "e2775e4b59c1bc2e31a2078c11b5a08c", "2be1fae5048a25582a679ca10905eb80",
+    "da86f292c6f41ea34fb2068df75ecc29", "220df19f85d69b1b562fa69a3c5beca5", "1f11d5d0355e0b556ccdb6c7f5083b4d",
+    "62526b78be79cb384633c91f83b4151b", "90ddbcb950843592dd47bbef00fdc876", "2fd0e41c5b8402277354a7391d2618e2",
+    "3cdf13e72dee4c581bafec70b85f9660", "afa2ffc137577092e2b654fa199d2c43", "8d683ee63e60d208e343ce48dbc44cac",
+    "705a4ef8ba2133729c20185c3d3a4763", "0861a861c3db4e94194211b77ed761b9", "4b00c27e8b26da7eab9d3a88dec8b031",
+    "5f397bf03084820cc8810d52e5b666e9", "63fafabb72c07bfbd3ddc9b1203104b8", "683e2140585b18452dd4ffbb93c95df9",
+    "286894e48e537f8763b56707d7d155c8", "a423deabc173dcf7e2c4c53e77d37cd1", "eb8168313e1cfdfdb5e986d5429cf172",
+    "27127daafc9accd2fb334ec3eba52323", "ee0715b96f72e3f7a22a5064fc592f4c", "29ee526770f2a11dcfa989d1ce88830f",
+    "0493370e054b09871130fe49af730a5a", "9b7b940f6c509f9e44a4ee140448ee46", "2915be4a1ecfdcbe3e023811a12bb6c7",
+    "7240e524bc51d8c4d440b1be55d1062c", "da63039d38cb4612b2dc36ba26684b93", "0f59cb5a4b522e2ac56c1a64f558ad9a",
+    "7bfe9d876c6d63c1d035da8fe21c409d", "acdace8078a32b1a182bfa4987ca1347"
+};
+
+static const char * varKey256[256] = {
+    "e35a6dcb19b201a01ebcfa8aa22b5759", "b29169cdcf2d83e838125a12ee6aa400", "d8f3a72fc3cdf74dfaf6c3e6b97b2fa6",
+    "1c777679d50037c79491a94da76a9a35", "9cf4893ecafa0a0247a898e040691559", "8fbb413703735326310a269bd3aa94b2",
+    "60e32246bed2b0e859e55c1cc6b26502", "ec52a212f80a09df6317021bc2a9819e", "f23e5b600eb70dbccf6c0b1d9a68182c",
+    "a3f599d63a82a968c33fe26590745970", "d1ccb9b1337002cbac42c520b5d67722", "cc111f6c37cf40a1159d00fb59fb0488",
+    "dc43b51ab609052372989a26e9cdd714", "4dcede8da9e2578f39703d4433dc6459", "1a4c1c263bbccfafc11782894685e3a8",
+    "937ad84880db50613423d6d527a2823d", "610b71dfc688e150d8152c5b35ebc14d", "27ef2495dabf323885aab39c80f18d8b",
+    "633cafea395bc03adae3a1e2068e4b4e", "6e1b482b53761cf631819b749a6f3724", "976e6f851ab52c771998dbb2d71c75a9",
+    "85f2ba84f8c307cf525e124c3e22e6cc", "6bcca98bf6a835fa64955f72de4115fe", "2c75e2d36eebd65411f14fd0eb1d2a06",
+    "bd49295006250ffca5100b6007a0eade", "a190527d0ef7c70f459cd3940df316ec", "bbd1097a62433f79449fa97d4ee80dbf",
+    "07058e408f5b99b0e0f061a1761b5b3b", "5fd1f13fa0f31e37fabde328f894eac2", "fc4af7c948df26e2ef3e01c1ee5b8f6f",
+    "829fd7208fb92d44a074a677ee9861ac", "ad9fc613a703251b54c64a0e76431711", "33ac9eccc4cc75e2711618f80b1548e8",
+    "2025c74b8ad8f4cda17ee2049c4c902d", "f85ca05fe528f1ce9b790166e8d551e7", "6f6238d8966048d4967154e0dad5a6c9",
+    "f2b21b4e7640a9b3346de8b82fb41e49", "f836f251ad1d11d49dc344628b1884e1", "077e9470ae7abea5a9769d49182628c3",
+    "e0dcc2d27fc9865633f85223cf0d611f", "be66cfea2fecd6bf0ec7b4352c99bcaa", "df31144f87a2ef523facdcf21a427804",
+    "b5bb0f5629fb6aae5e1839a3c3625d63", "3c9db3335306fe1ec612bdbfae6b6028", "3dd5c34634a79d3cfcc8339760e6f5f4",
+    "82bda118a3ed7af314fa2ccc5c07b761", "2937a64f7d4f46fe6fea3b349ec78e38", "225f068c28476605735ad671bb8f39f3",
+    "ae682c5ecd71898e08942ac9aa89875c", "5e031cb9d676c3022d7f26227e85c38f", "a78463fb064db5d52bb64bfef64f2dda",
+    "8aa9b75e784593876c53a00eae5af52b", "3f84566df23da48af692722fe980573a", "31690b5ed41c7eb42a1e83270a7ff0e6",
+    "77dd7702646d55f08365e477d3590eda", "4c022ac62b3cb78d739cc67b3e20bb7e", "092fa137ce18b5dfe7906f550bb13370",
+    "3e0cdadf2e68353c0027672c97144dd3", "d8c4b200b383fc1f2b2ea677618a1d27", "11825f99b0e9bb3477c1c0713b015aac",
+    "f8b9fffb5c187f7ddc7ab10f4fb77576", "ffb4e87a32b37d6f2c8328d3b5377802", "d276c13a5d220f4da9224e74896391ce",
+    "94efe7a0e2e031e2536da01df799c927", "8f8fd822680a85974e53a5a8eb9d38de", "e0f0a91b2e45f8cc37b7805a3042588d",
+    "597a6252255e46d6364dbeeda31e279c", "f51a0f694442b8f05571797fec7ee8bf", "9ff071b165b5198a93dddeebc54d09b5",
+    "c20a19fd5758b0c4bc1a5df89cf73877", "97120166307119ca2280e9315668e96f", "4b3b9f1e099c2a09dc091e90e4f18f0a",
+    "eb040b891d4b37f6851f7ec219cd3f6d", "9f0fdec08b7fd79aa39535bea42db92a", "2e70f168fc74bf911df240bcd2cef236",
+    "462ccd7f5fd1108dbc152f3cacad328b", "a4af534a7d0b643a01868785d86dfb95", "ab980296197e1a5022326c31da4bf6f3",
+    "f97d57b3333b6281b07d486db2d4e20c", "f33fa36720231afe4c759ade6bd62eb6", "fdcfac0c02ca538343c68117e0a15938",
+    "ad4916f5ee5772be764fc027b8a6e539", "2e16873e1678610d7e14c02d002ea845", "4e6e627c1acc51340053a8236d579576",
+    "ab0c8410aeeead92feec1eb430d652cb", "e86f7e23e835e114977f60e1a592202e", "e68ad5055a367041fade09d9a70a794b",
+    "0791823a3c666bb6162825e78606a7fe", "dcca366a9bf47b7b868b77e25c18a364", "684c9efc237e4a442965f84bce20247a",
+    "a858411ffbe63fdb9c8aa1bfaed67b52", "04bc3da2179c3015498b0e03910db5b8", "40071eeab3f935dbc25d00841460260f",
+    "0ebd7c30ed2016e08ba806ddb008bcc8", "15c6becf0f4cec7129cbd22d1a79b1b8", "0aeede5b91f721700e9e62edbf60b781",
+    "266581af0dcfbed1585e0a242c64b8df", "6693dc911662ae473216ba22189a511a", "7606fa36d86473e6fb3a1bb0e2c0adf5",
+    "112078e9e11fbb78e26ffb8899e96b9a", "40b264e921e9e4a82694589ef3798262", "8d4595cb4fa7026715f55bd68e2882f9",
+    "b588a302bdbc09197df1edae68926ed9", "33f7502390b8a4a221cfecd0666624ba", "3d20253adbce3be2373767c4d822c566",
+    "a42734a3929bf84cf0116c9856a3c18c", "e3abc4939457422bb957da3c56938c6d", "972bdd2e7c525130fadc8f76fc6f4b3f",
+    "84a83d7b94c699cbcb8a7d9b61f64093", "ce61d63514aded03d43e6ebfc3a9001f", "6c839dd58eeae6b8a36af48ed63d2dc9",
+    "cd5ece55b8da3bf622c4100df5de46f9", "3b6f46f40e0ac5fc0a9c1105f800f48d", "ba26d47da3aeb028de4fb5b3a854a24b",
+    "87f53bf620d3677268445212904389d5", "10617d28b5e0f4605492b182a5d7f9f6", "9aaec4fabbf6fae2a71feff02e372b39",
+    "3a90c62d88b5c42809abf782488ed130", "f1f1c5a40899e15772857ccb65c7a09a", "190843d29b25a3897c692ce1dd81ee52",
+    "a866bc65b6941d86e8420a7ffb0964db", "8193c6ff85225ced4255e92f6e078a14", "9661cb2424d7d4a380d547f9e7ec1cb9",
+    "86f93d9ec08453a071e2e2877877a9c8", "27eefa80ce6a4a9d598e3fec365434d2", "d62068444578e3ab39ce7ec95dd045dc",
+    "b5f71d4dd9a71fe5d8bc8ba7e6ea3048", "6825a347ac479d4f9d95c5cb8d3fd7e9", "e3714e94a5778955cc0346358e94783a",
+    "d836b44bb29e0c7d89fa4b2d4b677d2a", "5d454b75021d76d4b84f873a8f877b92", "c3498f7eced2095314fc28115885b33f",
+    "6e668856539ad8e405bd123fe6c88530", "8680db7f3a87b8605543cfdbe6754076", "6c5d03b13069c3658b3179be91b0800c",
+    "ef1b384ac4d93eda00c92add0995ea5f", "bf8115805471741bd5ad20a03944790f", "c64c24b6894b038b3c0d09b1df068b0b",
+    "3967a10cffe27d0178545fbf6a40544b", "7c85e9c95de1a9ec5a5363a8a053472d", "a9eec03c8abec7ba68315c2c8c2316e0",
+    "cac8e414c2f388227ae14986fc983524", "5d942b7f4622ce056c3ce3ce5f1dd9d6", "d240d648ce21a3020282c3f1b528a0b6",
+    "45d089c36d5c5a4efc689e3b0de10dd5", "b4da5df4becb5462e03a0ed00d295629", "dcf4e129136c1a4b7a0f38935cc34b2b",
+    "d9a4c7618b0ce48a3d5aee1a1c0114c4", "ca352df025c65c7b0bf306fbee0f36ba", "238aca23fd3409f38af63378ed2f5473",
+    "59836a0e06a79691b36667d5380d8188", "33905080f7acf1cdae0a91fc3e85aee4", "72c9e4646dbc3d6320fc6689d93e8833",
+    "ba77413dea5925b7f5417ea47ff19f59", "6cae8129f843d86dc786a0fb1a184970", "fcfefb534100796eebbd990206754e19",
+    "8c791d5fdddf470da04f3e6dc4a5b5b5", "c93bbdc07a4611ae4bb266ea5034a387", "c102e38e489aa74762f3efc5bb23205a",
+    "93201481665cbafc1fcc220bc545fb3d", "4960757ec6ce68cf195e454cfd0f32ca", "feec7ce6a6cbd07c043416737f1bbb33",
+    "11c5413904487a805d70a8edd9c35527", "347846b2b2e36f1f0324c86f7f1b98e2", "332eee1a0cbd19ca2d69b426894044f0",
+    "866b5b3977ba6efa5128efbda9ff03cd", "cc1445ee94c0f08cdee5c344ecd1e233", "be288319029363c2622feba4b05dfdfe",
+    "cfd1875523f3cd21c395651e6ee15e56", "cb5a408657837c53bf16f9d8465dce19", "ca0bf42cb107f55ccff2fc09ee08ca15",
+    "fdd9bbb4a7dc2e4a23536a5880a2db67", "ede447b362c484993dec9442a3b46aef", "10dffb05904bff7c4781df780ad26837",
+    "c33bc13e8de88ac25232aa7496398783", "ca359c70803a3b2a3d542e8781dea975", "bcc65b526f88d05b89ce8a52021fdb06",
+    "db91a38855c8c4643851fbfb358b0109", "ca6e8893a114ae8e27d5ab03a5499610", "6629d2b8df97da728cdd8b1e7f945077",
+    "4570a5a18cfc0dd582f1d88d5c9a1720", "72bc65aa8e89562e3f274d45af1cd10b", "98551da1a6503276ae1c77625f9ea615",
+    "0ddfe51ced7e3f4ae927daa3fe452cee", "db826251e4ce384b80218b0e1da1dd4c", "2cacf728b88abbad7011ed0e64a1680c",
+    "330d8ee7c5677e099ac74c9994ee4cfb", "edf61ae362e882ddc0167474a7a77f3a", "6168b00ba7859e0970ecfd757efecf7c",
+    "d1415447866230d28bb1ea18a4cdfd02", "516183392f7a8763afec68a060264141", "77565c8d73cfd4130b4aa14d8911710f",
+    "37232a4ed21ccc27c19c9610078cabac", "804f32ea71828c7d329077e712231666", "d64424f23cb97215e9c2c6f28d29eab7",
+    "023e82b533f68c75c238cebdb2ee89a2", "193a3d24157a51f1ee0893f6777417e7", "84ecacfcd400084d078612b1945f2ef5",
+    "1dcd8bb173259eb33a5242b0de31a455", "35e9eddbc375e792c19992c19165012b", "8a772231c01dfdd7c98e4cfddcc0807a",
+    "6eda7ff6b8319180ff0d6e65629d01c3", "c267ef0e2d01a993944dd397101413cb", "e9f80e9d845bcc0f62926af72eabca39",
+    "6702990727aa0878637b45dcd3a3b074", "2e2e647d5360e09230a5d738ca33471e", "1f56413c7add6f43d1d56e4f02190330",
+    "69cd0606e15af729d6bca143016d9842", "a085d7c1a500873a20099c4caa3c3f5b", "4fc0d230f8891415b87b83f95f2e09d1",
+    "4327d08c523d8eba697a4336507d1f42", "7a15aab82701efa5ae36ab1d6b76290f", "5bf0051893a18bb30e139a58fed0fa54",
+    "97e8adf65638fd9cdf3bc22c17fe4dbd", "1ee6ee326583a0586491c96418d1a35d", "26b549c2ec756f82ecc48008e529956b",
+    "70377b6da669b072129e057cc28e9ca5", "9c94b8b0cb8bcc919072262b3fa05ad9", "2fbb83dfd0d7abcb05cd28cad2dfb523",
+    "96877803de77744bb970d0a91f4debae", "7379f3370cf6e5ce12ae5969c8eea312", "02dc99fa3d4f98ce80985e7233889313",
+    "1e38e759075ba5cab6457da51844295a", "70bed8dbf615868a1f9d9b05d3e7a267", "234b148b8cb1d8c32b287e896903d150",
+    "294b033df4da853f4be3e243f7e513f4", "3f58c950f0367160adec45f2441e7411", "37f655536a704e5ace182d742a820cf4",
+    "ea7bd6bb63418731aeac790fe42d61e8", "e74a4c999b4c064e48bb1e413f51e5ea", "ba9ebefdb4ccf30f296cecb3bc1943e8",
+    "3194367a4898c502c13bb7478640a72d", "da797713263d6f33a5478a65ef60d412", "d1ac39bb1ef86b9c1344f214679aa376",
+    "2fdea9e650532be5bc0e7325337fd363", "d3a204dbd9c2af158b6ca67a5156ce4a", "3a0a0e75a8da36735aee6684d965a778",
+    "52fc3e620492ea99641ea168da5b6d52", "d2e0c7f15b4772467d2cfc873000b2ca", "563531135e0c4d70a38f8bdb190ba04e",
+    "a8a39a0f5663f4c0fe5f2d3cafff421a", "d94b5e90db354c1e42f61fabe167b2c0", "50e6d3c9b6698a7cd276f96b1473f35a",
+    "9338f08e0ebee96905d8f2e825208f43", "8b378c86672aa54a3a266ba19d2580ca", "cca7c3086f5f9511b31233da7cab9160",
+    "5b40ff4ec9be536ba23035fa4f06064c", "60eb5af8416b257149372194e8b88749", "2f005a8aed8a361c92e440c15520cbd1",
+    "7b03627611678a997717578807a800e2", "cf78618f74f6f3696e0a4779b90b5a77", "03720371a04962eaea0a852e69972858",
+    "1f8a8133aa8ccf70e2bd3285831ca6b7", "27936bd27fb1468fc8b48bc483321725", "b07d4f3e2cd2ef2eb545980754dfea0f",
+    "4bf85f1b5d54adbc307b0a048389adcb"
+};
+
+// AESAVS ECB Monte Carlo seeds and the ciphertext of the last of the
+// 100 outer iterations.
+static const Vector monteCarlo[] = {
+    { 128, "139a35422f1d61de3c91787fe0507afd", "b9145a768b7dc489a096b546f43b231f", "fb2649694783b551eacd9d5db6126d47" },
+    { 192, "b9a63e09e1dfc42e93a90d9bad739e5967aef672eedd5da9", "85a1f7a58167b389cddc8a9ff175ee26", "5d1196da8f184975e240949a25104554" },
+    { 256, "f9e8389f5b80712e3886cc1fa2d28a3b8c9cd88a2d4a54c6aa86ce0fef944be0", "b379777f9050e2a818f2940cbbd9aba4", "c5d2cb3d5b7ff0e23e308967ee074825" }
+};
+
+template<int KeyBits>
+static bool checkVariable(Engine engine, const char * const * varTxt, const char * const * varKey)
+{
+    const int keyBytes = KeyBits / 8;
+    unsigned char key[32], block[16], ciphertext[16];
+
+    for(int i = 0; i < 128; i++) {
+        memset(key, 0, sizeof(key));
+        leadingOnes(block, 16, i + 1);
+        fromHex(varTxt[i], ciphertext);
+        if( !check<KeyBits>(engine, key, block, ciphertext) ) return false;
+    }
+
+    for(int i = 0; i < KeyBits; i++) {
+        leadingOnes(key, keyBytes, i + 1);
+        memset(block, 0, sizeof(block));
+        fromHex(varKey[i], ciphertext);
+        if( !check<KeyBits>(engine, key, block, ciphertext) ) return false;
+    }
+
+    return true;
+}
+
+// AESAVS 6.4.1: each outer iteration chains 1000 encryptions and folds
+// the last 128 to 256 bits of output into the key.
+template<int KeyBits>
+static bool checkMonteCarlo(Engine engine, const Vector & vector)
+{
+    const int keyBytes = KeyBits / 8;
+    unsigned char key[32], text[32], expected[16];
+
+    fromHex(vector.key, key);
+    fromHex(vector.plaintext, text + 16);
+    fromHex(vector.ciphertext, expected);
+
+    for(int i = 0; i < 100; i++) {
+        Cipher<KeyBits> cipher(key, engine);
+
+        // text holds the previous and the current block back to back.
+        for(int j = 0; j < 1000; j++) {
+            memcpy(text, text + 16, 16);
+            cipher.encryptBlocks(text + 16, text + 16, 1);
+        }
+
+        for(int b = 0; b < keyBytes; b++) key[b] ^= text[32 - keyBytes + b];
+    }
+
+    return memcmp(text + 16, expected, 16) == 0;
+}
+
+static std::vector<unsigned char> fromHex(const char * hex)
+{
+    std::vector<unsigned char> out(strlen(hex) / 2);
+    fromHex(hex, out.data());
+    return out;
+}
+
+// SP 800-38A F.2.1 (CBC-AES128) and F.5.1 (CTR-AES128) over the same key
+// and four plaintext blocks.
+static const char * modeKey = "2b7e151628aed2a6abf7158809cf4f3c";
+static const char * modePlaintext =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+static bool checkCbc(Engine engine)
+{
+    std::vector<unsigned char> key = fromHex(modeKey), plaintext = fromHex(modePlaintext);
+    std::vector<unsigned char> iv = fromHex("000102030405060708090a0b0c0d0e0f"), chain = iv;
+    std::vector<unsigned char> expected = fromHex(
+        "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+        "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7");
+    std::vector<unsigned char> text(plaintext.size());
+
+    Cipher<128> cipher(key.data(), engine);
+    Cbc cbc(cipher);
+
+    cbc.encryptBlocks(chain.data(), plaintext.data(), text.data(), 4);
+    if( text != expected ) return false;
+    chain = iv;
+    cbc.decryptBlocks(chain.data(), text.data(), text.data(), 4);
+    return text == plaintext;
+}
+
+static bool checkCtr(Engine engine)
+{
+    std::vector<unsigned char> key = fromHex(modeKey), plaintext = fromHex(modePlaintext);
+    std::vector<unsigned char> counter = fromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+    std::vector<unsigned char> expected = fromHex(
+        "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+        "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+    std::vector<unsigned char> text(plaintext.size());
+
+    Cipher<128> cipher(key.data(), engine);
+    Ctr ctr(cipher, counter.data());
+
+    // An odd split checks that the keystream carries over between calls.
+    ctr.process(plaintext.data(), text.data(), 5);
+    ctr.process(plaintext.data() + 5, text.data() + 5, plaintext.size() - 5);
+    if( text != expected ) return false;
+    ctr.processAt(0, text.data(), text.data(), text.size());
+    return text == plaintext;
+}
+
+struct GcmVector
+{
+    int keyBits;
+    const char * key;
+    const char * iv;
+    const char * aad;
+    const char * plaintext;
+    const char * ciphertext;
+    const char * tag;
+};
+
+// Test cases 1-5 and 13-16 from the GCM specification (McGrew and Viega).
+static const char * gcmKey = "feffe9928665731c6d6a8f9467308308";
+static const char * gcmKey256 = "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308";
+static const char * gcmAad = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+static const char * gcmPlaintext =
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255";
+
+static const GcmVector gcmVectors[] = {
+    { 128, "00000000000000000000000000000000", "000000000000000000000000", "", "", "", "58e2fccefa7e3061367f1d57a4e7455a" },
+    { 128, "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+      "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf" },
+    { 128, gcmKey, "cafebabefacedbaddecaf888", "", gcmPlaintext,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985", "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { 128, gcmKey, "cafebabefacedbaddecaf888", gcmAad, gcmPlaintext,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", "5bc94fbc3221a5db94fae95ae7121a47" },
+    { 128, gcmKey, "cafebabefacedbad", gcmAad, gcmPlaintext,
+      "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+      "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598", "3612d2e79e3b0785561be14aaca2fccb" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "", "",
+      "530f8afbc74536b9a963b4f1c4cb738b" },
+    { 256, "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "",
+      "00000000000000000000000000000000", "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919" },
+    { 256, gcmKey256, "cafebabefacedbaddecaf888", "", gcmPlaintext,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+      "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662898015ad", "b094dac5d93471bdec1a502270e3cc6c" },
+    { 256, gcmKey256, "cafebabefacedbaddecaf888", gcmAad, gcmPlaintext,
+      "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+      "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662", "76fc6ece0f4e1768cddf8853bb2d551b" }
+};
+
+// Also checks that decrypt() rejects a flipped tag, ciphertext or AAD
+// bit and leaves no plaintext behind when it does.
+template<int KeyBits>
+static bool checkGcm(Engine engine, const GcmVector & vector)
+{
+    std::vector<unsigned char> key = fromHex(vector.key), iv = fromHex(vector.iv), aad = fromHex(vector.aad);
+    std::vector<unsigned char> expected = fromHex(vector.ciphertext), expectedTag = fromHex(vector.tag);
+    std::vector<unsigned char> plaintext = fromHex(vector.plaintext);
+    size_t length = expected.size();
+    std::vector<unsigned char> text(length + 1), tag(16);
+
+    Cipher<KeyBits> cipher(key.data(), engine);
+    Gcm gcm(cipher);
+
+    // Test cases 4 and 5 use the first 60 bytes of the shared plaintext.
+    gcm.encrypt(iv.data(), iv.size(), aad.data(), aad.size(), plaintext.data(), text.data(), length, tag.data());
+    if( memcmp(text.data(), expected.data(), length) != 0 || tag != expectedTag ) return false;
+    if( !gcm.decrypt(iv.data(), iv.size(), aad.data(), aad.size(), expected.data(), text.data(), length, tag.data()) ) return false;
+    if( memcmp(text.data(), plaintext.data(), length) != 0 ) return false;
+
+    tag[15] ^= 1;
+    if( gcm.decrypt(iv.data(), iv.size(), aad.data(), aad.size(), expected.data(), text.data(), length, tag.data()) ) return false;
+    for(size_t i = 0; i < length; i++) if( text[i] != 0 ) return false;
+    tag[15] ^= 1;
+
+    if( length > 0 ) {
+        expected[length - 1] ^= 0x80;
+        if( gcm.decrypt(iv.data(), iv.size(), aad.data(), aad.size(), expected.data(), text.data(), length, tag.data()) ) return false;
+        expected[length - 1] ^= 0x80;
+    }
+
+    if( aad.size() > 0 ) {
+        aad[0] ^= 1;
+        if( gcm.verify(iv.data(), iv.size(), aad.data(), aad.size(), expected.data(), length, tag.data()) ) return false;
+        aad[0] ^= 1;
+    }
+
+    return gcm.verify(iv.data(), iv.size(), aad.data(), aad.size(), expected.data(), length, tag.data());
+}
+
+// Anything past 2^32 - 2 blocks would wrap the 32-bit counter and reuse
+// keystream, so it must be refused before a byte is touched; the
+// buffers here are far too small for the lengths passed.
+static bool checkGcmLimit(Engine engine)
+{
+    if( sizeof(size_t) < 8 ) return true;
+
+    unsigned char key[16] = { 0 }, iv[12] = { 0 }, text[16] = { 0 }, tag[16] = { 0 };
+    Cipher<128> cipher(key, engine);
+    const Gcm gcm(cipher);
+    size_t tooLong = (size_t) Gcm::maxLength + 1;
+
+    return !gcm.encrypt(iv, sizeof(iv), 0, 0, text, text, tooLong, tag) &&
+           !gcm.decrypt(iv, sizeof(iv), 0, 0, text, text, tooLong, tag) &&
+           !gcm.verify(iv, sizeof(iv), 0, 0, text, tooLong, tag) &&
+           !gcm.encrypt(iv, sizeof(iv), text, (size_t) Gcm::maxAadLength + 1, text, text, 0, tag) &&
+           gcm.encrypt(iv, sizeof(iv), 0, 0, text, text, sizeof(text), tag);
+}
+
+struct XtsVector
+{
+    const char * dataKey;
+    const char * tweakKey;
+    const char * tweak;
+    const char * plaintext;
+    const char * ciphertext;
+};
+
+// IEEE 1619-2007 XTS-AES-128 vectors 1-4 and 15-18; the last four end in
+// a partial block and take the ciphertext-stealing path.
+static const char * xtsCounting =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+    "303132333435363738393a3b3c3d3e3f404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f808182838485868788898a8b8c8d8e8f"
+    "909192939495969798999a9b9c9d9e9fa0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+    "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+static const XtsVector xtsVectors[] = {
+    { "00000000000000000000000000000000", "00000000000000000000000000000000", "00000000000000000000000000000000",
+      "0000000000000000000000000000000000000000000000000000000000000000",
+      "917cf69ebd68b2ec9b9fe9a3eadda692cd43d2f59598ed858c02c2652fbf922e" },
+    { "11111111111111111111111111111111", "22222222222222222222222222222222", "33333333330000000000000000000000",
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "22222222222222222222222222222222", "33333333330000000000000000000000",
+      "4444444444444444444444444444444444444444444444444444444444444444",
+      "af85336b597afc1a900b2eb21ec949d292df4c047e0b21532186a5971a227a89" },
+    { "27182818284590452353602874713526", "31415926535897932384626433832795", "00000000000000000000000000000000",
+      xtsCounting,
+      "27a7479befa1d476489f308cd4cfa6e2a96e4bbe3208ff25287dd3819616e89cc78cf7f5e543445f8333d8fa7f560000"
+      "05279fa5d8b5e4ad40e736ddb4d35412328063fd2aab53e5ea1e0a9f332500a5df9487d07a5c92cc512c8866c7e860ce"
+      "93fdf166a24912b422976146ae20ce846bb7dc9ba94a767aaef20c0d61ad02655ea92dc4c4e41a8952c651d33174be51"
+      "a10c421110e6d81588ede82103a252d8a750e8768defffed9122810aaeb99f9172af82b604dc4b8e51bcb08235a6f434"
+      "1332e4ca60482a4ba1a03b3e65008fc5da76b70bf1690db4eae29c5f1badd03c5ccf2a55d705ddcd86d449511ceb7ec3"
+      "0bf12b1fa35b913f9f747a8afd1b130e94bff94effd01a91735ca1726acd0b197c4e5b03393697e126826fb6bbde8ecc"
+      "1e08298516e2c9ed03ff3c1b7860f6de76d4cecd94c8119855ef5297ca67e9f3e7ff72b1e99785ca0a7e7720c5b36dc6"
+      "d72cac9574c8cbbc2f801e23e56fd344b07f22154beba0f08ce8891e643ed995c94d9a69c9f1b5f499027a78572aeebd"
+      "74d20cc39881c213ee770b1010e4bea718846977ae119f7a023ab58cca0ad752afe656bb3c17256a9f6e9bf19fdd5a38"
+      "fc82bbe872c5539edb609ef4f79c203ebb140f2e583cb2ad15b4aa5b655016a8449277dbd477ef2c8d6c017db738b18d"
+      "eb4a427d1923ce3ff262735779a418f20a282df920147beabe421ee5319d0568" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+      "000102030405060708090a0b0c0d0e0f10", "6c1625db4671522d3d7599601de7ca09ed" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+      "000102030405060708090a0b0c0d0e0f1011", "d069444b7a7e0cab09e24447d24deb1fedbf" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+      "000102030405060708090a0b0c0d0e0f101112", "e5df1351c0544ba1350b3363cd8ef4beedbf9d" },
+    { "fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "bfbebdbcbbbab9b8b7b6b5b4b3b2b1b0", "9a785634120000000000000000000000",
+      "000102030405060708090a0b0c0d0e0f10111213", "9d84c813f719aa2c7be3f66171c7c5c2edbf9dac" }
+};
+
+static bool checkXts(Engine engine, const XtsVector & vector)
+{
+    std::vector<unsigned char> dataKey = fromHex(vector.dataKey), tweakKey = fromHex(vector.tweakKey), tweak = fromHex(vector.tweak);
+    std::vector<unsigned char> plaintext = fromHex(vector.plaintext), expected = fromHex(vector.ciphertext);
+    std::vector<unsigned char> text(plaintext.size());
+
+    Cipher<128> dataCipher(dataKey.data(), engine), tweakCipher(tweakKey.data(), engine);
+    Xts xts(dataCipher, tweakCipher);
+
+    if( !xts.encrypt(tweak.data(), plaintext.data(), text.data(), text.size()) || text != expected ) return false;
+    return xts.decrypt(tweak.data(), text.data(), text.data(), text.size()) && text == plaintext;
+}
+
+static bool checkModes(Engine engine)
+{
+    if( !checkCbc(engine) || !checkCtr(engine) ) return false;
+
+    for(size_t i = 0; i < sizeof(gcmVectors) / sizeof(gcmVectors[0]); i++) {
+        const GcmVector & v = gcmVectors[i];
+        if( !(v.keyBits == 128 ? checkGcm<128>(engine, v) : checkGcm<256>(engine, v)) ) return false;
+    }
+
+    if( !checkGcmLimit(engine) ) return false;
+
+    for(size_t i = 0; i < sizeof(xtsVectors) / sizeof(xtsVectors[0]); i++)
+        if( !checkXts(engine, xtsVectors[i]) ) return false;
+
+    return true;
+}
+
+static bool knownAnswerTest(Engine engine)
+{
+    if( selectEngine(engine) != engine ) return true;
+
+    for(size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        const Vector & v = vectors[i];
+        bool ok = v.keyBits == 128 ? checkHex<128>(engine, v.key, v.plaintext, v.ciphertext) :
+                  v.keyBits == 192 ? checkHex<192>(engine, v.key, v.plaintext, v.ciphertext) :
+                                     checkHex<256>(engine, v.key, v.plaintext, v.ciphertext);
+        if( !ok ) return false;
+    }
+
+    return checkVariable<128>(engine, varTxt128, varKey128) &&
+           checkVariable<192>(engine, varTxt192, varKey192) &&
+           checkVariable<256>(engine, varTxt256, varKey256) &&
+           checkMonteCarlo<128>(engine, monteCarlo[0]) &&
+           checkMonteCarlo<192>(engine, monteCarlo[1]) &&
+           checkMonteCarlo<256>(engine, monteCarlo[2]) &&
+           checkModes(engine);
+}
+
+// xorshift64*; quality is ample for picking test inputs.
+static inline uint64_t nextRandom(uint64_t & state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545f4914f6cdd1dULL;
+}
+
+static void fillRandom(uint64_t & state, unsigned char * out, size_t length)
+{
+    for(size_t i = 0; i < length; i += 8) {
+        uint64_t r = nextRandom(state);
+        memcpy(out + i, &r, length - i < 8 ? length - i : 8);
+    }
+}
+
+template<int KeyBits>
+static bool compare(Engine engine, uint64_t & state)
+{
+    static const size_t maxBlocks = 67;
+    unsigned char key[32], in[16 * maxBlocks], expected[16 * maxBlocks], out[16 * maxBlocks];
+    size_t blocks = 1 + nextRandom(state) % maxBlocks;
+
+    fillRandom(state, key, sizeof(key));
+    fillRandom(state, in, 16 * blocks);
+
+    Cipher<KeyBits> reference(key, Engine::Reference);
+    Cipher<KeyBits> cipher(key, engine);
+
+    reference.encryptBlocks(in, expected, blocks);
+    cipher.encryptBlocks(in, out, blocks);
+    if( memcmp(out, expected, 16 * blocks) != 0 ) return false;
+
+    cipher.decryptBlocks(out, out, blocks);
+    if( memcmp(out, in, 16 * blocks) != 0 ) return false;
+
+    if( memcmp(cipher.encrypt(Block::load(in)).bytes(), expected, 16) != 0 ) return false;
+    return memcmp(cipher.decrypt(Block::load(expected)).bytes(), in, 16) == 0;
+}
+
+static bool differentialTest(Engine engine, uint64_t iterations, uint64_t seed = 1)
+{
+    if( selectEngine(engine) != engine ) return true;
+
+    uint64_t state = seed | 1;
+    for(uint64_t i = 0; i < iterations; i++) {
+        bool ok = i % 3 == 0 ? compare<128>(engine, state) :
+                  i % 3 == 1 ? compare<192>(engine, state) :
+                               compare<256>(engine, state);
+        if( !ok ) return false;
+    }
+
+    return true;
+}
+
+template<int KeyBits>
+static bool countAllocations(Engine engine)
+{
+    static const size_t sizes[] = { 0, 1, 15, 16, 17, 767, 768, 769, 5000 };
+    unsigned char key[32] = { 0 };
+    char plaintext[5000], ciphertext[8192];
+    unsigned char decrypted[8192];
+    Cipher<KeyBits> cipher(key, engine);
+
+    memset(plaintext, 'a', sizeof(plaintext));
+
+    for(int pass = 0; pass < 2; pass++) {
+        // The first pass only warms up one-time state such as CPU
+        // feature detection.
+        uint64_t before = allocations();
+
+        for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            size_t length = cipher.encrypt(std::string_view(plaintext, sizes[i]), ciphertext);
+            size_t written;
+            if( !cipher.decrypt(std::string_view(ciphertext, length), decrypted, written) ) return false;
+            if( written < sizes[i] || memcmp(decrypted, plaintext, sizes[i]) != 0 ) return false;
+        }
+
+        if( pass == 1 && allocations() != before ) return false;
+    }
+
+    return true;
+}
+
+static bool allocationTest(Engine engine)
+{
+    if( selectEngine(engine) != engine ) return true;
+
+    return countAllocations<128>(engine) &&
+           countAllocations<192>(engine) &&
+           countAllocations<256>(engine);
+}
+
+// Deterministic per-task work; roughly one task in 32 is a hundred times
+// heavier so that some shares run dry early and steal.
+static uint64_t poolWork(uint64_t seed, size_t task)
+{
+    uint64_t state = (seed ^ (task * 0x9e3779b97f4a7c15ULL)) | 1;
+    int steps = nextRandom(state) % 32 == 0 ? 2000 : 20;
+    uint64_t value = 0;
+    for(int i = 0; i < steps; i++) value += nextRandom(state);
+    return value;
+}
+
+static bool threadPoolTest(unsigned int threads, uint64_t rounds, uint64_t seed = 1)
+{
+    const unsigned int submitters = 4;
+    ThreadPool pool(threads);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> running;
+
+    for(unsigned int s = 0; s < submitters; s++) {
+        running.push_back(std::thread([&, s] {
+            uint64_t state = (seed + s * 0x632be59bd9b4e019ULL) | 1;
+
+            for(uint64_t r = 0; r < rounds && ok; r++) {
+                size_t tasks = nextRandom(state) % 2048;
+                uint64_t roundSeed = nextRandom(state);
+                std::vector<uint64_t> results(tasks, 0);
+                std::vector<std::atomic<unsigned int>> runs(tasks);
+                for(size_t i = 0; i < tasks; i++) runs[i] = 0;
+
+                // Every eighth round nests a second run() in task 0.
+                bool nested = r % 8 == 0;
+                std::atomic<uint64_t> inner(0);
+
+                pool.run(tasks, [&](size_t i) {
+                    runs[i]++;
+                    results[i] = poolWork(roundSeed, i);
+                    if( nested && i == 0 ) pool.run(16, [&](size_t j) { inner += poolWork(roundSeed, j); });
+                });
+
+                uint64_t innerExpected = 0;
+                for(size_t j = 0; nested && tasks > 0 && j < 16; j++) innerExpected += poolWork(roundSeed, j);
+                if( nested && tasks > 0 && inner != innerExpected ) ok = false;
+
+                for(size_t i = 0; i < tasks; i++) {
+                    if( runs[i] != 1 || results[i] != poolWork(roundSeed, i) ) ok = false;
+                }
+
+                // runChunks must cover [0, length) exactly once.
+                size_t length = nextRandom(state) % 100000, chunk = 1 + nextRandom(state) % 5000;
+                std::vector<unsigned char> covered(length, 0);
+                pool.runChunks(length, chunk, [&](size_t offset, size_t n) {
+                    for(size_t b = offset; b < offset + n; b++) covered[b]++;
+                });
+                for(size_t b = 0; b < length; b++) if( covered[b] != 1 ) ok = false;
+            }
+        }));
+    }
+
+    for(size_t s = 0; s < running.size(); s++) running[s].join();
+    return ok;
+}
+
+// Inputs for one round of the sharing test and their serial results.
+struct SharingJob
+{
+    std::vector<unsigned char> blocks;
+    std::vector<unsigned char> encrypted;
+    Block single;
+    std::string text;
+    std::string ciphertext;
+};
+
+template<int KeyBits>
+static bool shareCipher(Engine engine, unsigned int threads, uint64_t rounds, uint64_t & state)
+{
+    unsigned char key[32];
+    fillRandom(state, key, sizeof(key));
+    const Cipher<KeyBits> cipher(key, engine);
+
+    std::vector<SharingJob> jobs(rounds);
+    for(size_t r = 0; r < jobs.size(); r++) {
+        SharingJob & job = jobs[r];
+        job.blocks.resize(16 * (1 + nextRandom(state) % 67));
+        fillRandom(state, job.blocks.data(), job.blocks.size());
+        job.encrypted.resize(job.blocks.size());
+        cipher.encryptBlocks(job.blocks.data(), job.encrypted.data(), job.blocks.size() / 16);
+        job.single = cipher.encrypt(Block::load(job.blocks.data()));
+        job.text.resize(nextRandom(state) % 200);
+        fillRandom(state, (unsigned char *) &job.text[0], job.text.size());
+        job.ciphertext = cipher.encrypt(job.text);
+    }
+
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> running;
+
+    for(unsigned int t = 0; t < threads; t++) {
+        running.push_back(std::thread([&, t] {
+            std::vector<unsigned char> out;
+            std::string ciphertext, plaintext;
+
+            // Each thread walks the jobs from a different start.
+            for(uint64_t r = 0; r < rounds && ok; r++) {
+                const SharingJob & job = jobs[(r + t * rounds / threads) % rounds];
+
+                out.resize(job.blocks.size());
+                cipher.encryptBlocks(job.blocks.data(), out.data(), out.size() / 16);
+                if( out != job.encrypted ) ok = false;
+                cipher.decryptBlocks(out.data(), out.data(), out.size() / 16);
+                if( out != job.blocks ) ok = false;
+
+                Block single = cipher.encrypt(Block::load(job.blocks.data()));
+                if( memcmp(single.bytes(), job.single.bytes(), 16) != 0 ) ok = false;
+                if( memcmp(cipher.decrypt(single).bytes(), job.blocks.data(), 16) != 0 ) ok = false;
+
+                // decrypt() returns the NUL-padded plaintext.
+                cipher.encrypt(std::string_view(job.text), ciphertext);
+                if( ciphertext != job.ciphertext ) ok = false;
+                if( !cipher.decrypt(std::string_view(ciphertext), plaintext) || plaintext.compare(0, job.text.size(), job.text) != 0 ) ok = false;
+            }
+        }));
+    }
+
+    for(size_t t = 0; t < running.size(); t++) running[t].join();
+    return ok;
+}
+
+static bool cipherSharingTest(unsigned int threads, uint64_t rounds, uint64_t seed = 1)
+{
+    const Engine engines[] = { Engine::Reference, Engine::TTable, Engine::AesNi, Engine::Bitsliced };
+    uint64_t state = seed | 1;
+
+    if( threads == 0 || rounds == 0 ) return true;
+
+    for(size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        if( selectEngine(engines[i]) != engines[i] ) continue;
+        if( !shareCipher<128>(engines[i], threads, rounds, state) ||
+            !shareCipher<192>(engines[i], threads, rounds, state) ||
+            !shareCipher<256>(engines[i], threads, rounds, state) ) return false;
+    }
+
+    return true;
+}
+
+static bool selfTest(uint64_t iterations)
+{
+    if( !threadPoolTest(4, 64) || !cipherSharingTest(4, 64) ) return false;
+
+    const Engine engines[] = { Engine::Reference, Engine::TTable, Engine::AesNi, Engine::Bitsliced };
+
+    for(size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        if( !knownAnswerTest(engines[i]) ) return false;
+        if( engines[i] != Engine::Reference && !differentialTest(engines[i], iterations) ) return false;
+        if( !allocationTest(engines[i]) ) return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char ** argv)
+{
+    uint64_t iterations = 256;
+
+    if( argc > 2 ) {
+        std::cerr << "usage: " << argv[0] << " [iterations]" << std::endl;
+        return 2;
+    }
+
+    if( argc == 2 ) {
+        char * end = 0;
+        iterations = strtoull(argv[1], &end, 10);
+        if( argv[1][0] < '0' || argv[1][0] > '9' || *end != '\0' ) {
+            std::cerr << "iterations must be a number" << std::endl;
+            return 2;
+        }
+    }
+
+    bool ok = selfTest(iterations);
+    std::cerr << "self-test " << (ok ? "passed" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}